@@ -0,0 +1,735 @@
+// Microbenchmarks de MemoryManager y ProcessScheduler con compuerta de regresión.
+//
+// Cada benchmark se ejecuta con repeticiones de calentamiento y luego N
+// repeticiones medidas; se reporta ns/op (mínimo, mediana, media y desviación)
+// y, si perf_event_open está disponible, ciclos/instrucciones/fallos por op.
+// Con --baseline se compara el mínimo por op (la métrica menos sensible al
+// ruido de otros procesos) contra un JSON guardado y el programa termina con
+// código 1 si algún benchmark empeora más que --threshold.
+//
+// La velocidad de la máquina varía entre ejecuciones (VMs, frecuencia de la
+// CPU), así que cada ejecución mide también el benchmark "calibracion", que
+// no usa código del simulador, y la comparación usa el tiempo relativo a él.
+// Un benchmark que supera el umbral se vuelve a medir (junto con la
+// calibración) hasta --confirm veces y solo cuenta como regresión si supera
+// el umbral en todos los intentos.
+//
+// Uso: ./os_sim_bench [--filter texto] [--warmup N] [--reps N]
+//                     [--json salida.json] [--baseline base.json] [--threshold 0.25]
+//                     [--confirm 3] [--append base.json]
+//
+// --append añade a una línea base existente solo los benchmarks que aún no
+// tiene, escalados a su calibración, sin tocar las entradas ya registradas.
+#include "MemoryManager.h"
+#include "ProcessScheduler.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Acceso a la lista de bloques para preparar heaps fragmentados sin pasar por free
+class MemoryManagerBench {
+public:
+    // n bloques de 'block' bytes; de los impares se libera 'freed_percent' % de forma
+    // repartida (nunca dos libres contiguos) y el resto del heap queda como un bloque libre
+    static void build_fragmented(MemoryManager& mm, size_t n, size_t block, int freed_percent) {
+        std::lock_guard<std::mutex> lock(mm.memory_mutex);
+        mm.memory_blocks.clear();
+        mm.memory_blocks.reserve(n + 1);
+        for (size_t i = 0; i < n; ++i) {
+            size_t k = i / 2;
+            bool is_free = (i % 2 == 1) &&
+                ((k + 1) * freed_percent / 100 > k * freed_percent / 100);
+            mm.memory_blocks.emplace_back(block, is_free, i * block);
+        }
+        size_t used = n * block;
+        if (used < mm.total_memory) {
+            mm.memory_blocks.emplace_back(mm.total_memory - used, true, used);
+        }
+    }
+
+    static void merge(MemoryManager& mm) {
+        std::lock_guard<std::mutex> lock(mm.memory_mutex);
+        mm.merge_free_blocks();
+    }
+};
+
+// Observa cuándo el scheduler despacha un proceso
+class ProcessSchedulerBench {
+public:
+    // Proceso en running_processes con ese PID (nullptr si aún no fue despachado)
+    static std::shared_ptr<Process> find_running(ProcessScheduler& ps, int pid) {
+        std::lock_guard<std::mutex> lock(ps.scheduler_mutex);
+        auto it = ps.running_processes.find(pid);
+        return it != ps.running_processes.end() ? it->second : nullptr;
+    }
+};
+
+namespace {
+
+// Los componentes registran cada operación en std::cout; mientras vive este
+// objeto las inserciones fallan de inmediato y no se formatea nada
+class QuietOutput {
+public:
+    QuietOutput() { std::cout.setstate(std::ios::badbit); }
+    ~QuietOutput() { std::cout.clear(); }
+};
+
+// Contadores de hardware del hilo actual vía perf_event_open (si el kernel lo permite)
+class PerfCounters {
+private:
+    struct Counter {
+        const char* name;
+        uint64_t config;
+        int fd;
+    };
+    std::vector<Counter> counters;
+
+public:
+    PerfCounters() {
+        counters = {
+            {"ciclos", PERF_COUNT_HW_CPU_CYCLES, -1},
+            {"instr", PERF_COUNT_HW_INSTRUCTIONS, -1},
+            {"fallos_cache", PERF_COUNT_HW_CACHE_MISSES, -1},
+            {"fallos_salto", PERF_COUNT_HW_BRANCH_MISSES, -1},
+        };
+        for (auto& c : counters) {
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = c.config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            c.fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~PerfCounters() {
+        for (auto& c : counters) {
+            if (c.fd >= 0) close(c.fd);
+        }
+    }
+
+    bool available() const {
+        return std::any_of(counters.begin(), counters.end(), [](const Counter& c) { return c.fd >= 0; });
+    }
+
+    size_t size() const { return counters.size(); }
+    const char* name(size_t i) const { return counters[i].name; }
+    bool has(size_t i) const { return counters[i].fd >= 0; }
+
+    void start() {
+        for (auto& c : counters) {
+            if (c.fd < 0) continue;
+            ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    // Detiene los contadores y suma sus valores a 'totals'
+    void stop(std::vector<uint64_t>& totals) {
+        totals.resize(counters.size(), 0);
+        for (size_t i = 0; i < counters.size(); ++i) {
+            if (counters[i].fd < 0) continue;
+            ioctl(counters[i].fd, PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            if (read(counters[i].fd, &value, sizeof(value)) == sizeof(value)) {
+                totals[i] += value;
+            }
+        }
+    }
+};
+
+// Cronómetro que el cuerpo del benchmark arranca y para alrededor de la región medida
+class Timer {
+private:
+    PerfCounters& perf;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    double elapsed_ns = 0;
+    std::vector<uint64_t> counts;
+
+    explicit Timer(PerfCounters& p) : perf(p) {}
+
+    void start() {
+        perf.start();
+        begin = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        auto end = std::chrono::steady_clock::now();
+        perf.stop(counts);
+        elapsed_ns += std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+};
+
+struct BenchSpec {
+    std::string name;
+    size_t ops;                           // Operaciones por repetición
+    int max_reps;                         // 0 = usar --reps
+    std::function<void(Timer&)> body;     // Ejecuta 'ops' operaciones dentro de start/stop
+};
+
+struct BenchResult {
+    std::string name;
+    double min_ns, median_ns, mean_ns, stddev_ns;
+    std::vector<double> counters_per_op;  // Vacío si no hay perf
+};
+
+struct Options {
+    std::string filter;
+    int warmup = 2;
+    int reps = 15;
+    std::string json_path;
+    std::string baseline_path;
+    double threshold = 0.25;
+    int confirm = 3;
+    std::string append_path;
+};
+
+// Nombre del benchmark de referencia usado para normalizar contra la línea base
+const std::string CALIBRATION = "calibracion";
+
+std::string heap_label(size_t heap) {
+    if (heap >= (1 << 20)) return std::to_string(heap >> 20) + "M";
+    return std::to_string(heap >> 10) + "K";
+}
+
+// --- Calibración ---
+
+// Recorrido de una lista de bloques e inserción/borrado en su mitad, sin pasar por
+// MemoryManager: mide la velocidad de la máquina con un patrón de acceso parecido
+// al de los benchmarks (recorrido secuencial + memmove), pero sin código del simulador
+void add_calibration(std::vector<BenchSpec>& specs) {
+    const size_t ops = 400;
+    specs.push_back({CALIBRATION, ops, 0, [ops](Timer& timer) {
+        std::vector<Block> blocks;
+        blocks.reserve(4097);
+        for (size_t i = 0; i < 4096; ++i) blocks.emplace_back(32, i % 2 == 1, i * 32);
+        size_t sink = 0;
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            for (const auto& block : blocks) {
+                if (block.is_free) sink += block.size;
+            }
+            blocks.insert(blocks.begin() + 2048, Block(16, true, i));
+            blocks.erase(blocks.begin() + 2048);
+        }
+        timer.stop();
+        if (sink == 1) std::abort();  // Evita que el compilador elimine el bucle
+    }});
+}
+
+// --- Benchmarks de MemoryManager ---
+
+// alloc(48) + free sobre un heap cuya primera mitad son bloques de 32 bytes con huecos
+void add_alloc_free(std::vector<BenchSpec>& specs, size_t heap, int frag, size_t ops) {
+    std::string name = "alloc_free/lista/heap=" + heap_label(heap) + "/frag=" + std::to_string(frag);
+    specs.push_back({name, ops, 0, [heap, frag, ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(heap);
+        MemoryManagerBench::build_fragmented(mm, heap / 2 / 32, 32, frag);
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            size_t addr = mm.alloc(48);
+            mm.free(addr);
+        }
+        timer.stop();
+    }});
+}
+
+// Mismo patrón con el backend de mapa de bits (la fragmentación se crea con alloc/free)
+void add_alloc_free_bitmap(std::vector<BenchSpec>& specs, size_t heap, int frag, size_t ops) {
+    std::string name = "alloc_free/bitmap16/heap=" + heap_label(heap) + "/frag=" + std::to_string(frag);
+    specs.push_back({name, ops, 0, [heap, frag, ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(heap, 16);
+        size_t n = heap / 2 / 32;
+        std::vector<size_t> addrs(n);
+        for (size_t i = 0; i < n; ++i) addrs[i] = mm.alloc(32);
+        for (size_t i = 1; i < n; i += 2) {
+            size_t k = i / 2;
+            if ((k + 1) * frag / 100 > k * frag / 100) mm.free(addrs[i]);
+        }
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            size_t addr = mm.alloc(48);
+            mm.free(addr);
+        }
+        timer.stop();
+    }});
+}
+
+// merge_free_blocks sobre n bloques alternos ocupado/libre (no hay nada que fusionar)
+void add_merge(std::vector<BenchSpec>& specs, size_t blocks, size_t ops) {
+    std::string name = "merge_free_blocks/bloques=" + std::to_string(blocks);
+    specs.push_back({name, ops, 0, [blocks, ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(blocks * 32);
+        MemoryManagerBench::build_fragmented(mm, blocks, 32, 100);
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            MemoryManagerBench::merge(mm);
+        }
+        timer.stop();
+    }});
+}
+
+void add_stats(std::vector<BenchSpec>& specs, size_t blocks, size_t ops) {
+    std::string name = "get_memory_stats/bloques=" + std::to_string(blocks);
+    specs.push_back({name, ops, 0, [blocks, ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(blocks * 32);
+        MemoryManagerBench::build_fragmented(mm, blocks, 32, 100);
+        size_t total, used, free;
+        size_t sink = 0;
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            mm.get_memory_stats(total, used, free);
+            sink += used;
+        }
+        timer.stop();
+        if (sink == 1) std::abort();  // Evita que el compilador elimine el bucle
+    }});
+}
+
+// alloc_many + free_many de 'ops' bloques de 16 bytes sobre un heap vacío (coste por bloque)
+void add_alloc_free_many(std::vector<BenchSpec>& specs, size_t heap, size_t ops) {
+    std::string name = "alloc_free_many/heap=" + heap_label(heap);
+    specs.push_back({name, ops, 0, [heap, ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(heap);
+        std::vector<size_t> sizes(ops, 16);
+
+        timer.start();
+        std::vector<size_t> addrs = mm.alloc_many(sizes);
+        mm.free_many(addrs);
+        timer.stop();
+    }});
+}
+
+// --- Benchmarks de ProcessScheduler ---
+
+// crear_proceso con el scheduler parado: asignación de la arena + encolado
+void add_crear_proceso(std::vector<BenchSpec>& specs, size_t ops) {
+    specs.push_back({"crear_proceso/n=" + std::to_string(ops), ops, 0, [ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(1 << 20);
+        ProcessScheduler ps(mm);
+
+        timer.start();
+        for (size_t i = 0; i < ops; ++i) {
+            ps.crear_proceso("bench", 64);
+        }
+        timer.stop();
+    }});
+}
+
+// crear_procesos: el mismo trabajo en un lote (una pasada del asignador, un lock, un despertar)
+void add_crear_procesos(std::vector<BenchSpec>& specs, size_t ops) {
+    specs.push_back({"crear_procesos/lote=" + std::to_string(ops), ops, 0, [ops](Timer& timer) {
+        QuietOutput quiet;
+        MemoryManager mm(1 << 20);
+        ProcessScheduler ps(mm);
+        std::vector<std::pair<std::string, size_t>> batch(ops, {"bench", 64});
+
+        timer.start();
+        ps.crear_procesos(batch);
+        timer.stop();
+    }});
+}
+
+// Scheduler compartido por todas las repeticiones de dispatch (se destruye antes que la memoria)
+struct DispatchFixture {
+    MemoryManager mm;
+    ProcessScheduler ps;
+
+    DispatchFixture() : mm(1 << 20), ps(mm) {
+        ps.set_execution_time_range(0, 0);
+        ps.start_scheduler();
+    }
+};
+
+// Latencia de despacho: desde crear_proceso hasta que el hilo del proceso arranca.
+// Se espera antes de cada medición para que el scheduler esté bloqueado en la cola
+void add_dispatch(std::vector<BenchSpec>& specs) {
+    auto fixture = std::make_shared<std::unique_ptr<DispatchFixture>>();
+
+    specs.push_back({"dispatch/latencia", 1, 10, [fixture](Timer& timer) {
+        QuietOutput quiet;
+        if (!*fixture) *fixture = std::make_unique<DispatchFixture>();
+        ProcessScheduler& ps = (*fixture)->ps;
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+        timer.start();
+        int pid = ps.crear_proceso("bench", 64);
+        std::shared_ptr<Process> process;
+        while (pid > 0 && !(process = ProcessSchedulerBench::find_running(ps, pid))) {
+            std::this_thread::yield();
+        }
+        while (process && process->started_ns.load() == 0) {
+            std::this_thread::yield();
+        }
+        timer.stop();
+    }});
+}
+
+std::vector<BenchSpec> build_specs() {
+    std::vector<BenchSpec> specs;
+    add_calibration(specs);
+
+    const size_t heaps[] = {8 << 10, 64 << 10, 1 << 20};
+    const size_t heap_ops[] = {2000, 400, 40};
+    for (int h = 0; h < 3; ++h) {
+        for (int frag : {0, 50, 100}) {
+            add_alloc_free(specs, heaps[h], frag, heap_ops[h]);
+        }
+        add_alloc_free_bitmap(specs, heaps[h], 100, heap_ops[h] * 10);
+    }
+
+    add_merge(specs, 128, 2000);
+    add_merge(specs, 1024, 400);
+    add_merge(specs, 16384, 20);
+
+    add_stats(specs, 128, 20000);
+    add_stats(specs, 16384, 200);
+
+    add_alloc_free_many(specs, 64 << 10, 2000);
+
+    add_crear_proceso(specs, 500);
+    add_crear_procesos(specs, 500);
+    add_dispatch(specs);
+    return specs;
+}
+
+BenchResult run_spec(const BenchSpec& spec, const Options& opts, PerfCounters& perf) {
+    int reps = spec.max_reps > 0 ? std::min(spec.max_reps, opts.reps) : opts.reps;
+
+    for (int i = 0; i < opts.warmup; ++i) {
+        Timer timer(perf);
+        spec.body(timer);
+    }
+
+    std::vector<double> per_op;
+    std::vector<uint64_t> totals(perf.size(), 0);
+    for (int i = 0; i < reps; ++i) {
+        Timer timer(perf);
+        spec.body(timer);
+        per_op.push_back(timer.elapsed_ns / spec.ops);
+        for (size_t c = 0; c < timer.counts.size(); ++c) totals[c] += timer.counts[c];
+    }
+
+    BenchResult result;
+    result.name = spec.name;
+    std::vector<double> sorted = per_op;
+    std::sort(sorted.begin(), sorted.end());
+    result.min_ns = sorted.front();
+    result.median_ns = sorted.size() % 2 ? sorted[sorted.size() / 2]
+        : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+    result.mean_ns = std::accumulate(per_op.begin(), per_op.end(), 0.0) / per_op.size();
+    double var = 0;
+    for (double v : per_op) var += (v - result.mean_ns) * (v - result.mean_ns);
+    result.stddev_ns = per_op.size() > 1 ? std::sqrt(var / (per_op.size() - 1)) : 0.0;
+
+    if (perf.available()) {
+        double total_ops = static_cast<double>(spec.ops) * reps;
+        for (size_t c = 0; c < totals.size(); ++c) {
+            result.counters_per_op.push_back(perf.has(c) ? totals[c] / total_ops : -1.0);
+        }
+    }
+    return result;
+}
+
+// Una entrada del JSON de resultados; los tiempos se multiplican por 'scale'
+std::string json_entry(const BenchResult& r, const PerfCounters& perf, double scale = 1.0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "    \"" << r.name << "\": {\"median_ns\": " << r.median_ns * scale
+        << ", \"mean_ns\": " << r.mean_ns * scale << ", \"min_ns\": " << r.min_ns * scale
+        << ", \"stddev_ns\": " << r.stddev_ns * scale;
+    for (size_t c = 0; c < r.counters_per_op.size(); ++c) {
+        if (r.counters_per_op[c] >= 0) {
+            out << ", \"" << perf.name(c) << "_por_op\": " << r.counters_per_op[c];
+        }
+    }
+    out << "}";
+    return out.str();
+}
+
+void write_json(const std::string& path, const std::vector<BenchResult>& results, const PerfCounters& perf) {
+    std::ofstream out(path);
+    out << "{\n  \"benchmarks\": {\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << json_entry(results[i], perf) << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+// Busca "<nombre>": { ... "min_ns": <valor> en el JSON generado por write_json
+bool baseline_min(const std::string& json, const std::string& name, double& value) {
+    const std::string field = "\"min_ns\":";
+    size_t pos = json.find("\"" + name + "\"");
+    if (pos == std::string::npos) return false;
+    size_t end = json.find('}', pos);
+    size_t key = json.find(field, pos);
+    if (key == std::string::npos || key > end) return false;
+    value = std::strtod(json.c_str() + key + field.size(), nullptr);
+    return true;
+}
+
+// Añade a la línea base los benchmarks que no tiene. Sus tiempos se escalan por
+// calibración_base / calibración_actual para que sean comparables con las entradas
+// existentes. Retorna el número de entradas añadidas, o -1 si falla
+int append_baseline(const std::string& path, const std::vector<BenchResult>& results, const PerfCounters& perf) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "[BENCH] Error: No se pudo leer la línea base " << path << "\n";
+        return -1;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string json = buffer.str();
+    in.close();
+
+    size_t close = json.rfind("\n  }\n}");
+    if (close == std::string::npos) {
+        std::cout << "[BENCH] Error: Formato de línea base no reconocido en " << path << "\n";
+        return -1;
+    }
+
+    double base_calib = 0, current_calib = 0;
+    baseline_min(json, CALIBRATION, base_calib);
+    for (const auto& r : results) {
+        if (r.name == CALIBRATION) current_calib = r.min_ns;
+    }
+    double scale = (base_calib > 0 && current_calib > 0) ? base_calib / current_calib : 1.0;
+
+    std::string added;
+    int count = 0;
+    for (const auto& r : results) {
+        double ignored;
+        if (baseline_min(json, r.name, ignored)) continue;
+        added += ",\n" + json_entry(r, perf, scale);
+        std::cout << "[BENCH] Añadido a la línea base: " << r.name << "\n";
+        count++;
+    }
+    if (count == 0) return 0;
+
+    json.insert(close, added);
+    std::ofstream out(path);
+    out << json;
+    std::cout << "[BENCH] Escala de calibración aplicada: " << std::setprecision(3) << scale << "\n";
+    return count;
+}
+
+// Cambio relativo del benchmark frente a la línea base, normalizado por la calibración
+// de cada lado (sin calibración en la línea base se comparan los tiempos directamente)
+double relative_change(double current, double current_calib, double base, double base_calib) {
+    if (current_calib > 0 && base_calib > 0) {
+        return (current / current_calib) / (base / base_calib) - 1.0;
+    }
+    return current / base - 1.0;
+}
+
+// Compara contra la línea base. Los benchmarks por encima del umbral se vuelven a
+// medir junto con la calibración hasta opts.confirm veces. Retorna el número de
+// regresiones, o -1 si no se pudo leer la línea base
+int compare_baseline(const std::vector<BenchResult>& results, const std::vector<BenchSpec>& specs,
+                     const Options& opts, PerfCounters& perf) {
+    std::ifstream in(opts.baseline_path);
+    if (!in) {
+        std::cout << "\n[BENCH] Error: No se pudo leer la línea base " << opts.baseline_path << "\n";
+        std::cout << "[BENCH] Genérala primero en esta máquina con 'make bench-baseline'\n";
+        return -1;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string json = buffer.str();
+
+    auto find_spec = [&specs](const std::string& name) -> const BenchSpec* {
+        for (const auto& spec : specs) {
+            if (spec.name == name) return &spec;
+        }
+        return nullptr;
+    };
+    const BenchSpec* calibration = find_spec(CALIBRATION);
+
+    double base_calib = 0, current_calib = 0;
+    if (!baseline_min(json, CALIBRATION, base_calib)) {
+        std::cout << "\n[BENCH] Aviso: la línea base no tiene '" << CALIBRATION
+                  << "'; se comparan tiempos sin normalizar\n";
+    }
+    for (const auto& r : results) {
+        if (r.name == CALIBRATION) current_calib = r.min_ns;
+    }
+
+    std::cout << "\n=== Comparación con " << opts.baseline_path << " (mínimo por op relativo a '"
+              << CALIBRATION << "', umbral +" << opts.threshold * 100 << "%) ===\n";
+    if (base_calib > 0 && current_calib > 0) {
+        std::cout << "Calibración: base " << base_calib << " ns, actual " << current_calib
+                  << " ns (" << std::showpos << (current_calib / base_calib - 1.0) * 100
+                  << std::noshowpos << "% de tiempo de calibración)\n";
+    }
+    std::cout << std::left << std::setw(42) << "Benchmark" << std::right << std::setw(14) << "Base(ns)"
+              << std::setw(14) << "Actual(ns)" << std::setw(10) << "Cambio" << "  Estado\n";
+
+    int regressions = 0;
+    for (const auto& r : results) {
+        if (r.name == CALIBRATION) continue;
+
+        double base;
+        std::cout << std::left << std::setw(42) << r.name << std::right;
+        if (!baseline_min(json, r.name, base) || base <= 0) {
+            std::cout << std::setw(14) << "-" << std::setw(14) << r.min_ns << std::setw(10) << "-"
+                      << "  NUEVO\n";
+            continue;
+        }
+
+        double current = r.min_ns;
+        double change = relative_change(current, current_calib, base, base_calib);
+        int attempts = 0;
+        const BenchSpec* spec = find_spec(r.name);
+        while (change > opts.threshold && attempts < opts.confirm && spec) {
+            // Repetir con una calibración medida justo antes, por si la máquina cambió de velocidad
+            attempts++;
+            double calib = calibration ? run_spec(*calibration, opts, perf).min_ns : current_calib;
+            double retry = run_spec(*spec, opts, perf).min_ns;
+            double retry_change = relative_change(retry, calib, base, base_calib);
+            if (retry_change < change) {
+                change = retry_change;
+                current = retry;
+            }
+        }
+
+        bool regressed = change > opts.threshold;
+        regressions += regressed;
+        std::cout << std::setw(14) << base << std::setw(14) << current
+                  << std::setw(9) << std::showpos << change * 100 << std::noshowpos << "%"
+                  << (regressed ? "  REGRESIÓN" : "  OK");
+        if (attempts > 0) std::cout << " (" << attempts << " repeticiones)";
+        std::cout << "\n";
+    }
+    return regressions;
+}
+
+void usage(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--filter texto] [--warmup N] [--reps N]\n"
+              << "       [--json salida.json] [--baseline base.json] [--threshold 0.25]\n"
+              << "       [--confirm 3] [--append base.json]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                return 2;
+            }
+            if (arg == "--filter") opts.filter = argv[++i];
+            else if (arg == "--warmup") opts.warmup = std::stoi(argv[++i]);
+            else if (arg == "--reps") opts.reps = std::stoi(argv[++i]);
+            else if (arg == "--json") opts.json_path = argv[++i];
+            else if (arg == "--baseline") opts.baseline_path = argv[++i];
+            else if (arg == "--threshold") opts.threshold = std::stod(argv[++i]);
+            else if (arg == "--confirm") opts.confirm = std::stoi(argv[++i]);
+            else if (arg == "--append") opts.append_path = argv[++i];
+            else {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opts.reps < 1 || opts.warmup < 0 || opts.confirm < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    PerfCounters perf;
+    std::cout << "[BENCH] Calentamiento: " << opts.warmup << " | Repeticiones: " << opts.reps
+              << " | Contadores de hardware: " << (perf.available() ? "sí" : "no disponibles") << "\n\n";
+
+    std::cout << std::left << std::setw(42) << "Benchmark" << std::right << std::setw(12) << "Mediana"
+              << std::setw(12) << "Media" << std::setw(12) << "Mín" << std::setw(10) << "Desv%";
+    if (perf.available()) {
+        for (size_t c = 0; c < perf.size(); ++c) std::cout << std::setw(14) << perf.name(c);
+    }
+    std::cout << "\n" << std::string(perf.available() ? 144 : 88, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::vector<BenchSpec> specs = build_specs();
+    std::vector<BenchResult> results;
+    for (const auto& spec : specs) {
+        // La calibración se mide siempre: la comparación con la línea base la necesita
+        if (!opts.filter.empty() && spec.name != CALIBRATION &&
+            spec.name.find(opts.filter) == std::string::npos) continue;
+
+        BenchResult r = run_spec(spec, opts, perf);
+        results.push_back(r);
+
+        std::cout << std::left << std::setw(42) << r.name << std::right << std::setw(12) << r.median_ns
+                  << std::setw(12) << r.mean_ns << std::setw(12) << r.min_ns
+                  << std::setw(10) << (r.mean_ns > 0 ? 100.0 * r.stddev_ns / r.mean_ns : 0.0);
+        for (double v : r.counters_per_op) {
+            if (v >= 0) std::cout << std::setw(14) << v;
+            else std::cout << std::setw(14) << "-";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "(tiempos en ns por operación)\n";
+
+    if (!opts.json_path.empty()) {
+        write_json(opts.json_path, results, perf);
+        std::cout << "[BENCH] Resultados guardados en " << opts.json_path << "\n";
+    }
+
+    if (!opts.append_path.empty() && append_baseline(opts.append_path, results, perf) < 0) {
+        return 1;
+    }
+
+    int regressions = 0;
+    if (!opts.baseline_path.empty()) {
+        regressions = compare_baseline(results, specs, opts, perf);
+    }
+    {
+        QuietOutput quiet;
+        specs.clear();  // Detiene el scheduler de dispatch sin ensuciar el reporte
+    }
+
+    if (!opts.baseline_path.empty()) {
+        if (regressions < 0) return 1;
+        if (regressions > 0) {
+            std::cout << "[BENCH] " << regressions << " regresión(es) por encima del umbral\n";
+            return 1;
+        }
+        std::cout << "[BENCH] Sin regresiones\n";
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "BitmapAllocator.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITMAP_X86 1
+#endif
+
+namespace {
+
+// Kernel de búsqueda: retorna el índice de la primera palabra en [from, n)
+// distinta de 'pattern' (n si todas son iguales). Con pattern = ~0 salta
+// palabras llenas; con pattern = 0 salta palabras vacías.
+using ScanFn = size_t (*)(const uint64_t*, size_t, size_t, uint64_t);
+
+size_t scan_words_scalar(const uint64_t* words, size_t from, size_t n, uint64_t pattern) {
+    while (from < n && words[from] == pattern) {
+        ++from;
+    }
+    return from;
+}
+
+#ifdef BITMAP_X86
+// SSE4.1: compara 2 palabras (128 unidades) por instrucción
+__attribute__((target("sse4.1")))
+size_t scan_words_sse41(const uint64_t* words, size_t from, size_t n, uint64_t pattern) {
+    const __m128i pat = _mm_set1_epi64x(static_cast<long long>(pattern));
+    while (from + 2 <= n) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + from));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, pat)));
+        if (mask != 0x3) {
+            return from + __builtin_ctz(~mask & 0x3);
+        }
+        from += 2;
+    }
+    return scan_words_scalar(words, from, n, pattern);
+}
+
+// AVX2: compara 4 palabras (256 unidades) por instrucción
+__attribute__((target("avx2")))
+size_t scan_words_avx2(const uint64_t* words, size_t from, size_t n, uint64_t pattern) {
+    const __m256i pat = _mm256_set1_epi64x(static_cast<long long>(pattern));
+    while (from + 4 <= n) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + from));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, pat)));
+        if (mask != 0xF) {
+            return from + __builtin_ctz(~mask & 0xF);
+        }
+        from += 4;
+    }
+    return scan_words_scalar(words, from, n, pattern);
+}
+#endif
+
+// Selecciona el kernel una sola vez según la CPU
+ScanFn select_scan_kernel(const char** name) {
+#ifdef BITMAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "AVX2";
+        return scan_words_avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        *name = "SSE4.1";
+        return scan_words_sse41;
+    }
+#endif
+    *name = "escalar";
+    return scan_words_scalar;
+}
+
+const char* scan_kernel_name = nullptr;
+const ScanFn selected_scan = select_scan_kernel(&scan_kernel_name);
+
+constexpr size_t WORD_BITS = 64;
+constexpr uint64_t ALL_ONES = ~uint64_t(0);
+
+// Máscara con los bits [lo, hi) de una palabra (0 <= lo < hi <= 64)
+inline uint64_t range_mask(size_t lo, size_t hi) {
+    uint64_t upper = (hi == WORD_BITS) ? ALL_ONES : ((uint64_t(1) << hi) - 1);
+    return upper & (ALL_ONES << lo);
+}
+
+} // namespace
+
+// Constructor: crea los mapas de bits con todas las unidades libres
+BitmapAllocator::BitmapAllocator(size_t total_size, size_t unit)
+    : unit_size(unit), num_units(total_size / unit),
+      num_words((num_units + WORD_BITS - 1) / WORD_BITS),
+      used_bits(num_words, 0), run_end_bits(num_words, 0), scan_words(selected_scan) {
+    // Marcar como ocupado el relleno de la última palabra para que nunca se asigne
+    size_t tail = num_units % WORD_BITS;
+    if (tail != 0) {
+        used_bits.back() = ALL_ONES << tail;
+    }
+}
+
+const char* BitmapAllocator::kernel_name() {
+    return scan_kernel_name;
+}
+
+BitmapAllocator::ScanFn BitmapAllocator::scalar_kernel() {
+    return scan_words_scalar;
+}
+
+// First-Fit: recorre huecos libres saltando palabras llenas con el kernel SIMD
+size_t BitmapAllocator::alloc(size_t size) {
+    Cursor cursor;
+    return alloc(size, cursor);
+}
+
+// Si First-Fit colocó una región de 'units' unidades en 'start', ningún hueco anterior
+// tiene 'units' unidades, y asignar solo encoge huecos: una petición igual o mayor
+// puede empezar a buscar tras esa región. Una petición menor vuelve a la unidad 0
+size_t BitmapAllocator::alloc(size_t size, Cursor& cursor) {
+    // Antes de redondear: con tamaños cercanos a SIZE_MAX el redondeo desbordaría
+    if (size == 0 || size > capacity()) return npos;
+
+    size_t units = (size + unit_size - 1) / unit_size;
+    size_t pos = units >= cursor.units ? cursor.unit : 0;
+    cursor.units = units;
+    cursor.unit = num_units;  // Si no cabe, tampoco cabrá nada igual o mayor
+
+    while (pos < num_units) {
+        size_t start = find_next_zero(used_bits, pos);
+        if (start >= num_units) break;
+
+        size_t end = std::min(find_next_one(used_bits, start), num_units);
+        if (end - start >= units) {
+            set_range(used_bits, start, units);
+            run_end_bits[(start + units - 1) / WORD_BITS] |=
+                uint64_t(1) << ((start + units - 1) % WORD_BITS);
+            cursor.unit = start + units;
+            return start * unit_size;
+        }
+        pos = end;
+    }
+    return npos;
+}
+
+// Libera una región: localiza su final en run_end_bits y limpia con máscaras
+size_t BitmapAllocator::free(size_t start_addr) {
+    if (start_addr % unit_size != 0) return 0;
+
+    size_t start = start_addr / unit_size;
+    if (start >= num_units || !test_bit(used_bits, start)) return 0;
+
+    // Solo se puede liberar desde el inicio de una región
+    if (start > 0 && test_bit(used_bits, start - 1) && !test_bit(run_end_bits, start - 1)) {
+        return 0;
+    }
+
+    size_t last = find_next_one(run_end_bits, start);
+    size_t units = last - start + 1;
+    clear_range(used_bits, start, units);
+    run_end_bits[last / WORD_BITS] &= ~(uint64_t(1) << (last % WORD_BITS));
+    return units * unit_size;
+}
+
+// Reconstruye la lista de regiones para display_memory
+std::vector<Block> BitmapAllocator::decode_runs() const {
+    std::vector<Block> runs;
+    size_t pos = 0;
+
+    while (pos < num_units) {
+        if (test_bit(used_bits, pos)) {
+            size_t last = find_next_one(run_end_bits, pos);
+            runs.emplace_back((last - pos + 1) * unit_size, false, pos * unit_size);
+            pos = last + 1;
+        } else {
+            size_t end = std::min(find_next_one(used_bits, pos), num_units);
+            runs.emplace_back((end - pos) * unit_size, true, pos * unit_size);
+            pos = end;
+        }
+    }
+    return runs;
+}
+
+size_t BitmapAllocator::used_bytes() const {
+    size_t count = 0;
+    for (uint64_t word : used_bits) {
+        count += __builtin_popcountll(word);
+    }
+    // Descontar el relleno de la última palabra
+    size_t tail = num_units % WORD_BITS;
+    if (tail != 0) {
+        count -= WORD_BITS - tail;
+    }
+    return count * unit_size;
+}
+
+bool BitmapAllocator::test_bit(const std::vector<uint64_t>& bits, size_t i) const {
+    return (bits[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+
+// Primer bit a 0 en posición >= from (npos si no hay)
+size_t BitmapAllocator::find_next_zero(const std::vector<uint64_t>& bits, size_t from) const {
+    size_t w = from / WORD_BITS;
+    if (w >= num_words) return npos;
+
+    uint64_t word = ~bits[w] & (ALL_ONES << (from % WORD_BITS));
+    if (word != 0) return w * WORD_BITS + __builtin_ctzll(word);
+
+    w = scan_words(bits.data(), w + 1, num_words, ALL_ONES);
+    if (w >= num_words) return npos;
+    return w * WORD_BITS + __builtin_ctzll(~bits[w]);
+}
+
+// Primer bit a 1 en posición >= from (npos si no hay)
+size_t BitmapAllocator::find_next_one(const std::vector<uint64_t>& bits, size_t from) const {
+    size_t w = from / WORD_BITS;
+    if (w >= num_words) return npos;
+
+    uint64_t word = bits[w] & (ALL_ONES << (from % WORD_BITS));
+    if (word != 0) return w * WORD_BITS + __builtin_ctzll(word);
+
+    w = scan_words(bits.data(), w + 1, num_words, 0);
+    if (w >= num_words) return npos;
+    return w * WORD_BITS + __builtin_ctzll(bits[w]);
+}
+
+void BitmapAllocator::set_range(std::vector<uint64_t>& bits, size_t from, size_t count) {
+    size_t end = from + count;
+    while (from < end) {
+        size_t w = from / WORD_BITS;
+        size_t hi = std::min(end - w * WORD_BITS, WORD_BITS);
+        bits[w] |= range_mask(from % WORD_BITS, hi);
+        from = w * WORD_BITS + hi;
+    }
+}
+
+void BitmapAllocator::clear_range(std::vector<uint64_t>& bits, size_t from, size_t count) {
+    size_t end = from + count;
+    while (from < end) {
+        size_t w = from / WORD_BITS;
+        size_t hi = std::min(end - w * WORD_BITS, WORD_BITS);
+        bits[w] &= ~range_mask(from % WORD_BITS, hi);
+        from = w * WORD_BITS + hi;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef BITMAP_ALLOCATOR_H
+#define BITMAP_ALLOCATOR_H
+
+#include "MemoryManager.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Backend de memoria basado en mapa de bits para granularidad fija.
+// Cada bit representa una unidad de 'unit_size' bytes (16, 64, ...).
+// No usa cabeceras de bloque: el final de cada región ocupada se marca
+// en un segundo mapa de bits (run_end_bits). No es thread-safe; lo
+// protege el memory_mutex del MemoryManager que lo contiene.
+class BitmapAllocator {
+private:
+    // Kernel de búsqueda: primera palabra en [from, n) distinta de 'pattern'
+    using ScanFn = size_t (*)(const uint64_t* words, size_t from, size_t n, uint64_t pattern);
+
+    size_t unit_size;                   // Bytes por unidad
+    size_t num_units;                   // Unidades gestionadas
+    size_t num_words;                   // Palabras de 64 bits por mapa
+    std::vector<uint64_t> used_bits;    // 1 = unidad ocupada (relleno final a 1)
+    std::vector<uint64_t> run_end_bits; // 1 = última unidad de una región ocupada
+    ScanFn scan_words;                  // Kernel elegido para la CPU (Tests.cpp lo cambia al escalar)
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Posición de búsqueda que se conserva entre asignaciones de un mismo lote.
+    // Antes de 'unit' no queda ningún hueco libre de 'units' unidades o más
+    struct Cursor {
+        size_t unit = 0;
+        size_t units = 0;
+    };
+
+    // Constructor: 'total_size' se redondea hacia abajo a múltiplo de 'unit_size'
+    BitmapAllocator(size_t total_size, size_t unit_size);
+
+    // First-Fit sobre el mapa de bits. Retorna la dirección o npos si no hay espacio
+    // (también con size == 0 o mayor que la capacidad)
+    size_t alloc(size_t size);
+
+    // Como alloc, pero continúa la búsqueda desde 'cursor' mientras las peticiones no
+    // encojan (mismo resultado que First-Fit desde la unidad 0) y lo avanza
+    size_t alloc(size_t size, Cursor& cursor);
+
+    // Libera la región que empieza en 'start_addr'. Retorna los bytes liberados (0 si falla)
+    size_t free(size_t start_addr);
+
+    // Decodifica el mapa de bits en regiones (libres y ocupadas) ordenadas por dirección
+    std::vector<Block> decode_runs() const;
+
+    // Bytes ocupados actualmente
+    size_t used_bytes() const;
+
+    // Bytes gestionados (num_units * unit_size)
+    size_t capacity() const { return num_units * unit_size; }
+
+    size_t get_unit_size() const { return unit_size; }
+
+    // Nombre del kernel de búsqueda seleccionado en tiempo de ejecución
+    static const char* kernel_name();
+
+private:
+    bool test_bit(const std::vector<uint64_t>& bits, size_t i) const;
+    size_t find_next_zero(const std::vector<uint64_t>& bits, size_t from) const;
+    size_t find_next_one(const std::vector<uint64_t>& bits, size_t from) const;
+    void set_range(std::vector<uint64_t>& bits, size_t from, size_t count);
+    void clear_range(std::vector<uint64_t>& bits, size_t from, size_t count);
+
+    // Kernel escalar de referencia, con el que se comparan los kernels SIMD
+    static ScanFn scalar_kernel();
+
+    // Las comprobaciones de Tests.cpp fuerzan el kernel escalar y leen los mapas de bits
+    friend class BitmapAllocatorTest;
+};
+
+#endif // BITMAP_ALLOCATOR_H
@@ -0,0 +1,26 @@
+#include "CommandLine.h"
+#include <sstream>
+
+std::vector<std::string> tokenize(const std::string& str) {
+    std::vector<std::string> tokens;
+    std::istringstream iss(str);
+    std::string token;
+
+    while (iss >> token) {
+        tokens.push_back(token);
+    }
+
+    return tokens;
+}
+
+bool is_repeat_token(const std::string& token) {
+    return !token.empty() && (token[0] == 'x' || token[0] == 'X');
+}
+
+bool parse_repeat(const std::string& token, size_t& count) {
+    if (!is_repeat_token(token) || token.size() < 2 || token.size() > 7) return false;
+    if (token.find_first_not_of("0123456789", 1) != std::string::npos) return false;
+
+    count = std::stoull(token.substr(1));
+    return count >= 1 && count <= MAX_REPEAT;
+}
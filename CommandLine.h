@@ -0,0 +1,23 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Análisis de líneas de comando compartido por Shell y ControlServer
+
+// Máximo de repeticiones aceptado en un sufijo de lote x<N>
+const size_t MAX_REPEAT = 100000;
+
+// Divide una línea en tokens separados por espacios
+std::vector<std::string> tokenize(const std::string& str);
+
+// true si el token tiene forma de sufijo de lote (empieza por 'x' o 'X')
+bool is_repeat_token(const std::string& token);
+
+// Interpreta un sufijo de lote "x<N>" (p. ej. x1000). Retorna false si N no es
+// un número entre 1 y MAX_REPEAT
+bool parse_repeat(const std::string& token, size_t& count);
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,419 @@
+#include "ControlServer.h"
+#include "CommandLine.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace {
+
+const int MAX_EVENTS = 64;
+const size_t READ_CHUNK = 16384;
+const size_t MAX_LINE = 65536;          // Línea sin '\n' más larga aceptada
+const size_t OUTPUT_HIGH_WATER = 1 << 20; // Deja de procesar entrada con tanta salida pendiente
+
+// Añade una respuesta OK con el texto dado como líneas de datos
+void append_ok(std::string& out, const std::string& body) {
+    size_t lines = std::count(body.begin(), body.end(), '\n');
+    out += "OK " + std::to_string(lines) + "\n";
+    out += body;
+}
+
+void append_err(std::string& out, const std::string& message) {
+    out += "ERR " + message + "\n";
+}
+
+// Deja libre la ruta del socket: solo borra un socket huérfano de una ejecución anterior.
+// Si la ruta no es un socket o hay otro servidor escuchando en ella, no se toca
+bool clear_stale_socket(const std::string& path, const sockaddr_un& addr) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) < 0) {
+        if (errno == ENOENT) return true;
+        std::cout << "[SERVER] Error: lstat(" << path << "): " << std::strerror(errno) << "\n";
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cout << "[SERVER] Error: " << path << " existe y no es un socket\n";
+        return false;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        std::cout << "[SERVER] Error: socket(): " << std::strerror(errno) << "\n";
+        return false;
+    }
+    int rc = connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    int connect_errno = errno;
+    close(probe);
+
+    if (rc == 0) {
+        std::cout << "[SERVER] Error: " << path << " en uso por otro servidor\n";
+        return false;
+    }
+    if (connect_errno != ECONNREFUSED) {
+        std::cout << "[SERVER] Error: connect(" << path << "): " << std::strerror(connect_errno) << "\n";
+        return false;
+    }
+    if (unlink(path.c_str()) < 0 && errno != ENOENT) {
+        std::cout << "[SERVER] Error: unlink(" << path << "): " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ControlServer::ControlServer(MemoryManager& mm, ProcessScheduler& ps, const std::string& path)
+    : memory_manager(mm), process_scheduler(ps), socket_path(path),
+      listen_fd(-1), epoll_fd(-1), wake_fd(-1), server_running(false) {
+    std::cout << "[SERVER] Inicializando servidor de control en " << socket_path << "\n";
+}
+
+ControlServer::~ControlServer() {
+    stop();
+    std::cout << "[SERVER] Destruyendo servidor de control\n";
+}
+
+// Crea el socket de escucha, epoll y el hilo del servidor
+bool ControlServer::start() {
+    if (server_running.load()) return true;
+
+    if (socket_path.size() >= sizeof(sockaddr_un::sun_path)) {
+        std::cout << "[SERVER] Error: Ruta de socket demasiado larga\n";
+        return false;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    if (!clear_stale_socket(socket_path, addr)) {
+        return false;
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cout << "[SERVER] Error: socket(): " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0) {
+        std::cout << "[SERVER] Error: bind/listen: " << std::strerror(errno) << "\n";
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        std::cout << "[SERVER] Error: epoll/eventfd: " << std::strerror(errno) << "\n";
+        stop();
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+    server_running = true;
+    server_thread = std::thread(&ControlServer::server_loop, this);
+    std::cout << "[SERVER] Servidor de control escuchando en " << socket_path << "\n";
+    return true;
+}
+
+// Para el hilo del servidor y libera los descriptores
+void ControlServer::stop() {
+    if (server_running.exchange(false)) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+        if (server_thread.joinable()) {
+            server_thread.join();
+        }
+        std::cout << "[SERVER] Servidor de control detenido\n";
+    }
+
+    for (auto& pair : connections) {
+        close(pair.first);
+    }
+    connections.clear();
+
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+        listen_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (wake_fd >= 0) {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
+
+// Bucle de eventos: un solo hilo atiende a todos los clientes
+void ControlServer::server_loop() {
+    epoll_event events[MAX_EVENTS];
+
+    while (server_running.load()) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cout << "[SERVER] Error: epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == wake_fd) continue;  // stop() ya puso server_running a false
+            if (fd == listen_fd) {
+                accept_clients();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+
+            bool alive = true;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                // Procesar lo que quede por leer antes de cerrar
+                handle_readable(it->second);
+                alive = false;
+            }
+            if (alive && (events[i].events & EPOLLOUT)) {
+                alive = handle_writable(it->second);
+            }
+            if (alive && (events[i].events & EPOLLIN)) {
+                alive = handle_readable(it->second);
+            }
+
+            if (!alive) {
+                close_connection(fd);
+            }
+        }
+    }
+}
+
+void ControlServer::accept_clients() {
+    while (true) {
+        int client = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cout << "[SERVER] Error: accept: " << std::strerror(errno) << "\n";
+            }
+            return;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = client;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &ev) < 0) {
+            close(client);
+            continue;
+        }
+        connections.emplace(client, Connection(client));
+    }
+}
+
+// Lee todo lo disponible, procesa las líneas completas y responde en lote
+bool ControlServer::handle_readable(Connection& conn) {
+    char buffer[READ_CHUNK];
+    bool peer_closed = false;
+
+    while (conn.output.size() < OUTPUT_HIGH_WATER) {
+        ssize_t r = read(conn.fd, buffer, sizeof(buffer));
+        if (r > 0) {
+            conn.input.append(buffer, static_cast<size_t>(r));
+            continue;
+        }
+        if (r == 0) {
+            peer_closed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    process_input(conn);
+    if (conn.input.size() > MAX_LINE && conn.input.find('\n') == std::string::npos) {
+        return false;  // Línea demasiado larga: cliente mal formado
+    }
+
+    if (!handle_writable(conn)) return false;
+    // Si el cliente cerró, solo mantenerlo mientras queden respuestas por enviar
+    return !peer_closed || !conn.output.empty();
+}
+
+// Envía la salida pendiente; con el socket lleno espera a EPOLLOUT
+bool ControlServer::handle_writable(Connection& conn) {
+    while (!conn.output.empty()) {
+        ssize_t w = send(conn.fd, conn.output.data(), conn.output.size(), MSG_NOSIGNAL);
+        if (w > 0) {
+            conn.output.erase(0, static_cast<size_t>(w));
+            continue;
+        }
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+
+    // Con la salida vaciada se pueden procesar las peticiones que quedaron en espera
+    if (conn.output.empty() && conn.input.find('\n') != std::string::npos) {
+        process_input(conn);
+        return handle_writable(conn);
+    }
+
+    update_events(conn);
+    return true;
+}
+
+void ControlServer::process_input(Connection& conn) {
+    size_t pos = 0;
+    size_t newline;
+
+    while (conn.output.size() < OUTPUT_HIGH_WATER &&
+           (newline = conn.input.find('\n', pos)) != std::string::npos) {
+        std::string line = conn.input.substr(pos, newline - pos);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        execute_request(line, conn.output);
+        pos = newline + 1;
+    }
+    conn.input.erase(0, pos);
+}
+
+// Ejecuta un comando sobre los mismos MemoryManager y ProcessScheduler que el shell
+void ControlServer::execute_request(const std::string& line, std::string& out) {
+    std::vector<std::string> tokens = tokenize(line);
+    if (tokens.empty()) {
+        append_err(out, "petición vacía");
+        return;
+    }
+
+    std::string cmd = tokens[0];
+    std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::tolower);
+
+    try {
+        if (cmd == "ping" && tokens.size() == 1) {
+            append_ok(out, "");
+        } else if (cmd == "exec" && tokens.size() == 4 && is_repeat_token(tokens[3])) {
+            // Lote: un PID por línea, -1 para los que no se pudieron crear
+            size_t memory = std::stoull(tokens[2]);
+            size_t count;
+            if (!parse_repeat(tokens[3], count)) {
+                append_err(out, "número de repeticiones inválido");
+                return;
+            }
+            if (memory == 0) {
+                append_err(out, "argumento inválido");
+                return;
+            }
+            std::vector<int> pids = process_scheduler.crear_procesos(
+                std::vector<std::pair<std::string, size_t>>(count, {tokens[1], memory}));
+            std::string body;
+            for (int pid : pids) body += std::to_string(pid) + "\n";
+            append_ok(out, body);
+        } else if (cmd == "exec" && tokens.size() == 3) {
+            size_t memory = std::stoull(tokens[2]);
+            int pid = memory > 0 ? process_scheduler.crear_proceso(tokens[1], memory) : -1;
+            if (pid > 0) {
+                append_ok(out, std::to_string(pid) + "\n");
+            } else {
+                append_err(out, "no se pudo crear el proceso");
+            }
+        } else if (cmd == "alloc" && tokens.size() == 3 && is_repeat_token(tokens[2])) {
+            // Lote: una dirección por línea, -1 para las que no se pudieron asignar
+            size_t size = std::stoull(tokens[1]);
+            size_t count;
+            if (!parse_repeat(tokens[2], count)) {
+                append_err(out, "número de repeticiones inválido");
+                return;
+            }
+            if (size == 0) {
+                append_err(out, "argumento inválido");
+                return;
+            }
+            std::vector<size_t> addrs = memory_manager.alloc_many(std::vector<size_t>(count, size));
+            std::string body;
+            for (size_t addr : addrs) {
+                body += (addr == MemoryManager::npos ? std::string("-1") : std::to_string(addr)) + "\n";
+            }
+            append_ok(out, body);
+        } else if (cmd == "alloc" && (tokens.size() == 2 || tokens.size() == 3)) {
+            size_t size = std::stoull(tokens[1]);
+            size_t addr = MemoryManager::npos;
+            if (size > 0) {
+                addr = (tokens.size() == 3)
+                    ? process_scheduler.alloc_in_process(std::stoi(tokens[2]), size)
+                    : memory_manager.alloc(size);
+            }
+            if (addr != MemoryManager::npos) {
+                append_ok(out, std::to_string(addr) + "\n");
+            } else {
+                append_err(out, "no hay memoria suficiente");
+            }
+        } else if (cmd == "free" && tokens.size() == 2) {
+            if (process_scheduler.free_memory(std::stoull(tokens[1]))) {
+                append_ok(out, "");
+            } else {
+                append_err(out, "dirección no asignada");
+            }
+        } else if (cmd == "free" && tokens.size() > 2) {
+            // Lote: responde con el número de bloques liberados
+            std::vector<size_t> addrs;
+            for (size_t i = 1; i < tokens.size(); ++i) addrs.push_back(std::stoull(tokens[i]));
+            append_ok(out, std::to_string(process_scheduler.free_memory_many(addrs)) + "\n");
+        } else if (cmd == "kill" && tokens.size() == 2) {
+            if (process_scheduler.terminate_process(std::stoi(tokens[1]))) {
+                append_ok(out, "");
+            } else {
+                append_err(out, "proceso no encontrado");
+            }
+        } else if (cmd == "ps" && tokens.size() == 1) {
+            std::ostringstream oss;
+            process_scheduler.display_processes(oss);
+            append_ok(out, oss.str());
+        } else if (cmd == "mem" && tokens.size() == 1) {
+            std::ostringstream oss;
+            memory_manager.display_memory(oss);
+            append_ok(out, oss.str());
+        } else {
+            append_err(out, "comando no reconocido: " + line);
+        }
+    } catch (const std::exception& e) {
+        append_err(out, "argumento inválido");
+    }
+}
+
+void ControlServer::update_events(Connection& conn) {
+    bool want_write = !conn.output.empty();
+    if (want_write == conn.want_write) return;
+
+    // Con salida pendiente solo se espera EPOLLOUT: así se aplica contrapresión al cliente
+    epoll_event ev{};
+    ev.events = want_write ? EPOLLOUT : EPOLLIN;
+    ev.data.fd = conn.fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.want_write = want_write;
+}
+
+void ControlServer::close_connection(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
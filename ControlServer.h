@@ -0,0 +1,84 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include "MemoryManager.h"
+#include "ProcessScheduler.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+
+// Servidor de control local: socket Unix + epoll en un hilo propio.
+// Acepta muchos clientes concurrentes que envían comandos de una línea
+// (exec, alloc, free, kill, ps, mem, ping). exec y alloc aceptan un
+// sufijo x<N> y free varias direcciones para operar en lote. Las
+// peticiones pueden ir en pipeline: todas las líneas completas recibidas
+// se procesan y sus respuestas se envían juntas en una sola escritura.
+//
+// Formato de respuesta:
+//   OK <n>\n seguido de n líneas de datos
+//   ERR <mensaje>\n
+class ControlServer {
+private:
+    // Estado de un cliente conectado
+    struct Connection {
+        int fd;
+        std::string input;    // Bytes recibidos aún sin procesar
+        std::string output;   // Respuestas pendientes de enviar
+        bool want_write;      // Registrado con EPOLLOUT
+
+        explicit Connection(int f) : fd(f), want_write(false) {}
+    };
+
+    MemoryManager& memory_manager;
+    ProcessScheduler& process_scheduler;
+    std::string socket_path;
+
+    int listen_fd;                               // Socket de escucha
+    int epoll_fd;                                // Instancia de epoll
+    int wake_fd;                                 // eventfd para despertar el bucle al parar
+    std::atomic<bool> server_running;
+    std::thread server_thread;
+    std::unordered_map<int, Connection> connections;  // Solo lo toca server_thread
+
+public:
+    // Constructor
+    ControlServer(MemoryManager& mm, ProcessScheduler& ps, const std::string& path);
+
+    // Destructor
+    ~ControlServer();
+
+    // Crea el socket y lanza el hilo del servidor. Retorna false si falla
+    bool start();
+
+    // Para el servidor y cierra todas las conexiones
+    void stop();
+
+private:
+    // Bucle principal de epoll
+    void server_loop();
+
+    // Acepta todas las conexiones pendientes
+    void accept_clients();
+
+    // Lee del cliente y procesa las peticiones completas. Retorna false si se cerró
+    bool handle_readable(Connection& conn);
+
+    // Envía las respuestas pendientes. Retorna false si hubo error
+    bool handle_writable(Connection& conn);
+
+    // Procesa las líneas completas del buffer de entrada
+    void process_input(Connection& conn);
+
+    // Ejecuta una petición y añade la respuesta a 'out'
+    void execute_request(const std::string& line, std::string& out);
+
+    // Actualiza los eventos de epoll según haya salida pendiente
+    void update_events(Connection& conn);
+
+    // Cierra y elimina una conexión
+    void close_connection(int fd);
+};
+
+#endif // CONTROL_SERVER_H
@@ -1,8 +1,19 @@
 #include "MemoryManager.h"
+#include "BitmapAllocator.h"
 #include <algorithm>
 
 // Constructor: inicializa la memoria con un solo bloque libre
-MemoryManager::MemoryManager(size_t total_size) : total_memory(total_size) {
+MemoryManager::MemoryManager(size_t total_size, size_t unit_size) : total_memory(total_size) {
+    if (unit_size > 0) {
+        // Backend de mapa de bits: no necesita lista de bloques
+        bitmap = std::make_unique<BitmapAllocator>(total_size, unit_size);
+        total_memory = bitmap->capacity();
+        std::cout << "[MEMORY] Inicializando gestor de memoria (mapa de bits, unidad de "
+                  << unit_size << " bytes, kernel " << BitmapAllocator::kernel_name()
+                  << ") con " << total_memory << " bytes\n";
+        return;
+    }
+    
     // Crear un bloque inicial que representa toda la memoria disponible
     memory_blocks.emplace_back(total_size, true, 0);
     std::cout << "[MEMORY] Inicializando gestor de memoria con " << total_size << " bytes\n";
@@ -16,6 +27,22 @@ MemoryManager::~MemoryManager() {
 size_t MemoryManager::alloc(size_t size) {
     std::lock_guard<std::mutex> lock(memory_mutex);
     
+    // Igual que alloc_many y el mapa de bits: un bloque de 0 bytes no es una asignación
+    if (size == 0) {
+        std::cout << "[MEMORY] Error: No se pueden asignar 0 bytes\n";
+        return npos;
+    }
+    
+    if (bitmap) {
+        size_t addr = bitmap->alloc(size);
+        if (addr == BitmapAllocator::npos) {
+            std::cout << "[MEMORY] Error: No hay espacio suficiente para " << size << " bytes\n";
+            return npos;
+        }
+        std::cout << "[MEMORY] Asignados " << size << " bytes en dirección " << addr << "\n";
+        return addr;
+    }
+    
     // Buscar el primer bloque libre que sea lo suficientemente grande
     for (auto it = memory_blocks.begin(); it != memory_blocks.end(); ++it) {
         if (it->is_free && it->size >= size) {
@@ -45,13 +72,23 @@ size_t MemoryManager::alloc(size_t size) {
     
     // No se encontró espacio suficiente
     std::cout << "[MEMORY] Error: No hay espacio suficiente para " << size << " bytes\n";
-    return 0;  // 0 indica fallo en la asignación
+    return npos;  // npos indica fallo en la asignación
 }
 
 // Libera un bloque de memoria
 bool MemoryManager::free(size_t start_addr) {
     std::lock_guard<std::mutex> lock(memory_mutex);
     
+    if (bitmap) {
+        size_t freed = bitmap->free(start_addr);
+        if (freed == 0) {
+            std::cout << "[MEMORY] Error: No se encontró bloque en dirección " << start_addr << "\n";
+            return false;
+        }
+        std::cout << "[MEMORY] Liberados " << freed << " bytes en dirección " << start_addr << "\n";
+        return true;
+    }
+    
     // Buscar el bloque con la dirección especificada
     for (auto& block : memory_blocks) {
         if (block.start_addr == start_addr && !block.is_free) {
@@ -69,23 +106,142 @@ bool MemoryManager::free(size_t start_addr) {
     return false;
 }
 
+// Asignación en lote: recorre la lista de bloques una sola vez y en cada hueco
+// atiende, en orden, las peticiones pendientes que quepan. Cada petición queda
+// en el primer hueco (por dirección) con espacio al llegar a él
+std::vector<size_t> MemoryManager::alloc_many(const std::vector<size_t>& sizes) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    
+    std::vector<size_t> addrs(sizes.size(), npos);
+    size_t allocated = 0, allocated_bytes = 0;
+    
+    if (bitmap) {
+        // El cursor evita volver a la unidad 0 en cada petición (p. ej. 'alloc 64 x1000')
+        BitmapAllocator::Cursor cursor;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            size_t addr = bitmap->alloc(sizes[i], cursor);
+            if (addr != BitmapAllocator::npos) {
+                addrs[i] = addr;
+                allocated++;
+                allocated_bytes += sizes[i];
+            }
+        }
+    } else {
+        std::vector<size_t> pending;
+        pending.reserve(sizes.size());
+        size_t min_pending = total_memory + 1;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            if (sizes[i] > 0) {
+                pending.push_back(i);
+                min_pending = std::min(min_pending, sizes[i]);
+            }
+        }
+        
+        std::vector<Block> rebuilt;
+        rebuilt.reserve(memory_blocks.size() + pending.size());
+        
+        for (const auto& block : memory_blocks) {
+            if (!block.is_free || pending.empty() || block.size < min_pending) {
+                rebuilt.push_back(block);
+                continue;
+            }
+            
+            size_t addr = block.start_addr;
+            size_t remaining = block.size;
+            size_t kept = 0;
+            for (size_t k = 0; k < pending.size(); ++k) {
+                size_t idx = pending[k];
+                if (sizes[idx] <= remaining) {
+                    rebuilt.emplace_back(sizes[idx], false, addr);
+                    addrs[idx] = addr;
+                    addr += sizes[idx];
+                    remaining -= sizes[idx];
+                    allocated++;
+                    allocated_bytes += sizes[idx];
+                } else {
+                    pending[kept++] = idx;
+                }
+            }
+            pending.resize(kept);
+            
+            if (remaining > 0) {
+                rebuilt.emplace_back(remaining, true, addr);
+            }
+        }
+        memory_blocks.swap(rebuilt);
+    }
+    
+    std::cout << "[MEMORY] Asignación en lote: " << allocated << "/" << sizes.size() 
+              << " bloques, " << allocated_bytes << " bytes\n";
+    return addrs;
+}
+
+// Liberación en lote: marca todos los bloques en una pasada y fusiona una sola vez
+size_t MemoryManager::free_many(const std::vector<size_t>& start_addrs) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    
+    size_t freed = 0, freed_bytes = 0;
+    
+    if (bitmap) {
+        for (size_t addr : start_addrs) {
+            size_t bytes = bitmap->free(addr);
+            if (bytes > 0) {
+                freed++;
+                freed_bytes += bytes;
+            }
+        }
+    } else {
+        std::vector<size_t> sorted(start_addrs);
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+        
+        // Los bloques se mantienen ordenados por dirección
+        auto target = sorted.begin();
+        for (auto& block : memory_blocks) {
+            while (target != sorted.end() && *target < block.start_addr) ++target;
+            if (target == sorted.end()) break;
+            if (*target == block.start_addr && !block.is_free) {
+                block.is_free = true;
+                freed++;
+                freed_bytes += block.size;
+            }
+        }
+        
+        if (freed > 0) {
+            merge_free_blocks();
+        }
+    }
+    
+    std::cout << "[MEMORY] Liberación en lote: " << freed << "/" << start_addrs.size() 
+              << " bloques, " << freed_bytes << " bytes\n";
+    return freed;
+}
+
 // Muestra el estado actual de todos los bloques de memoria
-void MemoryManager::display_memory() const {
+void MemoryManager::display_memory(std::ostream& out) const {
     std::lock_guard<std::mutex> lock(memory_mutex);
     
-    std::cout << "\n=== Estado de la Memoria ===\n";
-    std::cout << "Dirección\tTamaño\t\tEstado\n";
-    std::cout << "----------------------------------------\n";
+    out << "\n=== Estado de la Memoria ===\n";
+    out << "Dirección\tTamaño\t\tEstado\n";
+    out << "----------------------------------------\n";
     
-    for (const auto& block : memory_blocks) {
-        std::cout << block.start_addr << "\t\t" << block.size << "\t\t"
-                  << (block.is_free ? "LIBRE" : "OCUPADO") << "\n";
+    // Con el backend de mapa de bits los bloques se obtienen decodificando las regiones;
+    // con la lista se recorre memory_blocks directamente, sin copiarla
+    std::vector<Block> decoded;
+    const std::vector<Block>* blocks = &memory_blocks;
+    if (bitmap) {
+        decoded = bitmap->decode_runs();
+        blocks = &decoded;
+    }
+    for (const auto& block : *blocks) {
+        out << block.start_addr << "\t\t" << block.size << "\t\t"
+            << (block.is_free ? "LIBRE" : "OCUPADO") << "\n";
     }
     
     size_t total, used, free;
     get_memory_stats(total, used, free);
-    std::cout << "----------------------------------------\n";
-    std::cout << "Total: " << total << " | Usado: " << used << " | Libre: " << free << "\n\n";
+    out << "----------------------------------------\n";
+    out << "Total: " << total << " | Usado: " << used << " | Libre: " << free << "\n\n";
 }
 
 // Obtiene estadísticas de uso de memoria
@@ -94,6 +250,12 @@ void MemoryManager::get_memory_stats(size_t& total, size_t& used, size_t& free)
     used = 0;
     free = 0;
     
+    if (bitmap) {
+        used = bitmap->used_bytes();
+        free = total - used;
+        return;
+    }
+    
     for (const auto& block : memory_blocks) {
         if (block.is_free) {
             free += block.size;
@@ -4,6 +4,7 @@
 #include <vector>
 #include <mutex>
 #include <iostream>
+#include <memory>
 
 // Estructura que representa un bloque de memoria
 struct Block {
@@ -14,27 +15,42 @@ struct Block {
     Block(size_t s, bool free, size_t addr) : size(s), is_free(free), start_addr(addr) {}
 };
 
+class BitmapAllocator;
+
 class MemoryManager {
 private:
     std::vector<Block> memory_blocks;  // Vector que simula la memoria
     size_t total_memory;               // Memoria total disponible
     mutable std::mutex memory_mutex;   // mutex se utiliza para que valso hilos no dañe la memoria
+    std::unique_ptr<BitmapAllocator> bitmap;  // Backend de mapa de bits (nullptr = lista de bloques)
 
 public:
-    // Constructor: inicializa la memoria con un bloque libre grande
-    MemoryManager(size_t total_size);
+    // Valor de retorno de alloc cuando no hay espacio (0 es una dirección válida)
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Constructor: inicializa la memoria con un bloque libre grande.
+    // Si unit_size > 0 usa el backend de mapa de bits con esa granularidad
+    MemoryManager(size_t total_size, size_t unit_size = 0);
 
     // Destructor
     ~MemoryManager();
     
-    // Retorna la dirección de inicio del bloque asignado (0 si falla)
+    // Retorna la dirección de inicio del bloque asignado (npos si falla)
     size_t alloc(size_t size);
     
     // Libera un bloque de memoria dado su dirección de inicio
     bool free(size_t start_addr);
     
-    // Muestra el estado actual de la memoria
-    void display_memory() const;
+    // Asigna varios bloques con una sola adquisición del mutex y una sola pasada
+    // por la lista de bloques. Retorna una dirección por tamaño (npos si esa petición falla)
+    std::vector<size_t> alloc_many(const std::vector<size_t>& sizes);
+    
+    // Libera varios bloques con una sola adquisición del mutex y una sola fusión.
+    // Retorna cuántos se liberaron
+    size_t free_many(const std::vector<size_t>& start_addrs);
+    
+    // Muestra el estado actual de la memoria (por defecto en std::cout)
+    void display_memory(std::ostream& out = std::cout) const;
     
     // Obtiene estadísticas de memoria
     void get_memory_stats(size_t& total, size_t& used, size_t& free) const;
@@ -42,6 +58,9 @@ public:
 private:
     // Función auxiliar para fusionar bloques libres adyacentes
     void merge_free_blocks();
+    
+    // El microbenchmark (Benchmark.cpp) mide merge_free_blocks directamente
+    friend class MemoryManagerBench;
 };
 
 #endif // MEMORY_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "ProcessArena.h"
+#include <algorithm>
+
+ProcessArena::ProcessArena(size_t b, size_t cap)
+    : base(b), capacity(cap), bump(0), used(0), released(false) {}
+
+// First-Fit en la lista de huecos (ordenada por dirección); si ninguno sirve, avanza el puntero bump
+size_t ProcessArena::alloc(size_t size) {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    if (released || size == 0) return npos;
+
+    size_t offset = capacity;
+    for (auto it = free_list.begin(); it != free_list.end(); ++it) {
+        if (it->second >= size) {
+            offset = it->first;
+            if (it->second == size) {
+                free_list.erase(it);
+            } else {
+                it->first += size;
+                it->second -= size;
+            }
+            break;
+        }
+    }
+
+    if (offset == capacity) {
+        if (capacity - bump < size) return npos;
+        offset = bump;
+        bump += size;
+    }
+
+    allocations[offset] = size;
+    used += size;
+    return base + offset;
+}
+
+// Devuelve la asignación a la lista de huecos, fusionándola con los huecos vecinos
+// (o baja el puntero bump si el hueco resultante queda en la cima)
+bool ProcessArena::free(size_t addr) {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    if (released || !contains(addr)) return false;
+
+    auto it = allocations.find(addr - base);
+    if (it == allocations.end()) return false;
+
+    size_t offset = it->first;
+    size_t size = it->second;
+    allocations.erase(it);
+    used -= size;
+
+    // free_list está ordenada por desplazamiento y sin huecos contiguos
+    auto next = std::lower_bound(free_list.begin(), free_list.end(), std::make_pair(offset, size_t(0)));
+    if (next != free_list.begin()) {
+        auto prev = next - 1;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            next = free_list.erase(prev);
+        }
+    }
+    if (next != free_list.end() && offset + size == next->first) {
+        size += next->second;
+        next = free_list.erase(next);
+    }
+
+    if (offset + size == bump) {
+        bump = offset;
+    } else {
+        free_list.insert(next, std::make_pair(offset, size));
+    }
+    return true;
+}
+
+// No recorre las asignaciones: el bloque entero vuelve al MemoryManager de una vez
+bool ProcessArena::release() {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    if (released) return false;
+    released = true;
+    return true;
+}
+
+void ProcessArena::get_stats(size_t& used_bytes, size_t& allocation_count, bool& is_released) const {
+    std::lock_guard<std::mutex> lock(arena_mutex);
+
+    used_bytes = used;
+    allocation_count = allocations.size();
+    is_released = released;
+}
@@ -0,0 +1,51 @@
+#ifndef PROCESS_ARENA_H
+#define PROCESS_ARENA_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <cstddef>
+
+// Sub-arena de un proceso: un bloque obtenido una sola vez del MemoryManager
+// dentro del cual el proceso hace sus propias asignaciones (puntero bump +
+// lista de huecos). Al terminar el proceso se libera el bloque completo con
+// una única llamada a MemoryManager::free, sin recorrer las asignaciones.
+class ProcessArena {
+private:
+    size_t base;                     // Dirección de inicio del bloque en el MemoryManager
+    size_t capacity;                 // Tamaño del bloque
+    size_t bump;                     // Desplazamiento del primer byte nunca asignado
+    size_t used;                     // Bytes asignados actualmente
+    bool released;                   // true cuando el bloque ya se devolvió al MemoryManager
+    std::vector<std::pair<size_t, size_t>> free_list;   // Huecos (desplazamiento, tamaño) bajo 'bump', ordenados y fusionados
+    std::unordered_map<size_t, size_t> allocations;     // Desplazamiento -> tamaño de cada asignación
+    mutable std::mutex arena_mutex;
+
+public:
+    // Valor de retorno de alloc cuando la arena no tiene espacio
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Constructor: la arena cubre [base, base + capacity)
+    ProcessArena(size_t base, size_t capacity);
+
+    // Asigna dentro de la arena. Retorna la dirección absoluta (npos si falla)
+    size_t alloc(size_t size);
+
+    // Libera una asignación hecha con alloc
+    bool free(size_t addr);
+
+    // Marca la arena como liberada. Retorna true solo la primera vez
+    bool release();
+
+    // true si la dirección cae dentro del bloque de la arena
+    bool contains(size_t addr) const { return addr >= base && addr - base < capacity; }
+
+    size_t get_base() const { return base; }
+    size_t get_capacity() const { return capacity; }
+
+    // Estadísticas: bytes usados, número de asignaciones y si ya fue liberada
+    void get_stats(size_t& used_bytes, size_t& allocation_count, bool& is_released) const;
+};
+
+#endif // PROCESS_ARENA_H
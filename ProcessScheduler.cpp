@@ -2,9 +2,11 @@
 #include <iostream>
 #include <chrono>
 #include <random>
+#include <algorithm>
 
 ProcessScheduler::ProcessScheduler(MemoryManager& mm) 
-    : memory_manager(mm), next_pid(1), scheduler_running(false) {
+    : memory_manager(mm), next_pid(1), scheduler_running(false), scheduler_tid(0),
+      min_execution_ms(1000), max_execution_ms(5000) {
     std::cout << "[SCHEDULER] Inicializando planificador de procesos\n";
 }
 
@@ -15,24 +17,31 @@ ProcessScheduler::~ProcessScheduler() {
 
 // Crea un nuevo proceso y lo añade a la cola de listos
 int ProcessScheduler::crear_proceso(const std::string& name, size_t memory_required) {
-    std::lock_guard<std::mutex> lock(scheduler_mutex);
-    
     int pid = next_pid++;
     //guardando su nombre y la memoria que pide.
     auto process = std::make_shared<Process>(pid, name, memory_required);
     
-    //mira si hay memoria disponible
-    process->memory_address = memory_manager.alloc(memory_required);
-    
-    if (process->memory_address == 0) {
-        std::cout << "[SCHEDULER] Error: No se pudo asignar memoria para el proceso " 
-                  << name << " (PID: " << pid << ")\n";
-        return -1; // Error en la creación
+    // Asignar y registrar la arena bajo scheduler_mutex (orden scheduler -> memoria):
+    // así un free concurrente nunca ve el bloque asignado sin dueño
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        
+        //mira si hay memoria disponible
+        process->memory_address = memory_manager.alloc(memory_required);
+        
+        if (process->memory_address == MemoryManager::npos) {
+            std::cout << "[SCHEDULER] Error: No se pudo asignar memoria para el proceso " 
+                      << name << " (PID: " << pid << ")\n";
+            return -1; // Error en la creación
+        }
+        
+        // El bloque asignado es la arena del proceso; se añade a la cola de listos
+        process->arena = std::make_unique<ProcessArena>(process->memory_address, memory_required);
+        arena_owners[process->memory_address] = process;
+        live_processes[pid] = process;
+        ready_queue.push(process);
     }
     
-    // Añadir el proceso a la cola de listos
-    ready_queue.push(process);
-    
     std::cout << "[SCHEDULER] Proceso creado: " << name << " (PID: " << pid 
               << ", Memoria: " << memory_required << " bytes en dirección " 
               << process->memory_address << ")\n";
@@ -43,41 +52,118 @@ int ProcessScheduler::crear_proceso(const std::string& name, size_t memory_requi
     return pid;
 }
 
+// Crea varios procesos: una pasada del asignador, un solo encolado bajo el lock y un solo aviso
+std::vector<int> ProcessScheduler::crear_procesos(const std::vector<std::pair<std::string, size_t>>& batch) {
+    std::vector<int> pids(batch.size(), -1);
+    if (batch.empty()) return pids;
+    
+    std::vector<size_t> sizes;
+    sizes.reserve(batch.size());
+    for (const auto& request : batch) {
+        sizes.push_back(request.second);
+    }
+    
+    // Reservar un rango contiguo de PIDs
+    int first_pid = next_pid.fetch_add(static_cast<int>(batch.size()));
+    
+    size_t created = 0;
+    {
+        // Igual que crear_proceso: asignación y registro de las arenas son atómicos
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        std::vector<size_t> addrs = memory_manager.alloc_many(sizes);
+        
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (addrs[i] == MemoryManager::npos) continue;
+            
+            auto process = std::make_shared<Process>(first_pid + static_cast<int>(i), batch[i].first, batch[i].second);
+            process->memory_address = addrs[i];
+            process->arena = std::make_unique<ProcessArena>(addrs[i], batch[i].second);
+            pids[i] = process->pid;
+            arena_owners[process->memory_address] = process;
+            live_processes[process->pid] = process;
+            ready_queue.push(std::move(process));
+            ++created;
+        }
+    }
+    
+    std::cout << "[SCHEDULER] Lote de procesos: " << created << "/" << batch.size() 
+              << " creados";
+    if (created < batch.size()) {
+        std::cout << " (" << batch.size() - created << " sin memoria)";
+    }
+    std::cout << "\n";
+    
+    // Un solo aviso: el scheduler vacía toda la cola en una iteración
+    if (created > 0) {
+        cv.notify_one();
+    }
+    
+    return pids;
+}
+
 // Inicia el hilo
 void ProcessScheduler::start_scheduler() {
     if (!scheduler_running.load()) {
         scheduler_running = true;
+        scheduler_started_at = std::chrono::steady_clock::now();
         scheduler_thread = std::thread(&ProcessScheduler::scheduler_loop, this);
         std::cout << "[SCHEDULER] Scheduler iniciado\n";
     }
 }
 
+// Cambia la duración simulada de los procesos
+void ProcessScheduler::set_execution_time_range(int min_ms, int max_ms) {
+    min_execution_ms = std::max(0, min_ms);
+    max_execution_ms = std::max(min_execution_ms, max_ms);
+}
+
 // Para el scheduler y espera a que termine
 void ProcessScheduler::stop_scheduler() {
     if (scheduler_running.load()) {
-        scheduler_running = false;
+        {
+            // Bajo el lock: collect_process_stats solo lee relojes de hilos con el
+            // scheduler en marcha, así nunca coincide con los join de abajo
+            std::lock_guard<std::mutex> lock(scheduler_mutex);
+            scheduler_running = false;
+        }
         cv.notify_all();
         
         if (scheduler_thread.joinable()) {
             scheduler_thread.join();
         }
+        scheduler_tid = 0;
         
-        // Esperar a que terminen todos los procesos en ejecución
+        // Esperar a que terminen todos los procesos en ejecución (sin el lock:
+        // cada hilo lo toma al liberar su arena)
         for (auto& pair : running_processes) {
             if (pair.second->thread_ptr && pair.second->thread_ptr->joinable()) {
                 pair.second->thread_ptr->join();
             }
-            // Liberar memoria del proceso
-            memory_manager.free(pair.second->memory_address);
+        }
+        
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        
+        // Liberar memoria de los procesos (si no la liberó ya el propio hilo)
+        for (auto& pair : running_processes) {
+            release_process_memory(*pair.second);
         }
         running_processes.clear();
         
+        // Los procesos que no llegaron a despacharse también devuelven su arena
+        while (!ready_queue.empty()) {
+            release_process_memory(*ready_queue.front());
+            ready_queue.pop();
+        }
+        live_processes.clear();
+        
         std::cout << "[SCHEDULER] Scheduler detenido\n";
     }
 }
 
 // Función principal
 void ProcessScheduler::scheduler_loop() {
+    scheduler_tid = current_thread_id();
+    
     while (scheduler_running.load()) {
         std::unique_lock<std::mutex> lock(scheduler_mutex);
         
@@ -85,7 +171,8 @@ void ProcessScheduler::scheduler_loop() {
         cleanup_finished_processes();
         
         // Esperar hasta que haya un proceso en la cola o se detenga 
-        cv.wait(lock, [this] { 
+        // (con timeout para recoger periódicamente los procesos terminados)
+        cv.wait_for(lock, std::chrono::milliseconds(500), [this] { 
             return !ready_queue.empty() || !scheduler_running.load(); 
         });
         
@@ -96,6 +183,13 @@ void ProcessScheduler::scheduler_loop() {
             auto process = ready_queue.front();
             ready_queue.pop();
             
+            // kill en cola ya liberó su arena: no se le crea hilo
+            if (process->kill_requested.load()) {
+                std::cout << "[SCHEDULER] Descartando proceso " << process->name 
+                          << " (PID: " << process->pid << "), terminado en cola\n";
+                continue;
+            }
+            
             std::cout << "[SCHEDULER] Ejecutando proceso " << process->name 
                       << " (PID: " << process->pid << ")\n";
             
@@ -122,92 +216,280 @@ void ProcessScheduler::execute_process(std::shared_ptr<Process> process) {
 
 // Simula la ejecución de un proceso
 void ProcessScheduler::process_execution(std::shared_ptr<Process> process) {
+    process->tid = current_thread_id();
+    process->started_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    
     std::cout << "[PROCESO " << process->pid << "] Iniciando ejecución de " 
               << process->name << "\n";
     
     // Simular tiempo de ejecución variable (1-5 segundos)
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1000, 5000);
+    std::uniform_int_distribution<> dis(min_execution_ms, max_execution_ms);
     int execution_time = dis(gen);
     
     // Simular trabajo del proceso
     auto start_time = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(execution_time)) {
+    while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(execution_time) &&
+           !process->kill_requested.load()) {
         // Simular trabajo (imprimir estado cada segundo)
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         std::cout << "[PROCESO " << process->pid << "] " << process->name 
                   << " trabajando... (Memoria: " << process->memory_address << ")\n";
+        process->cpu_ns = current_thread_cpu_ns();
     }
+    process->cpu_ns = current_thread_cpu_ns();
     
-    std::cout << "[PROCESO " << process->pid << "] " << process->name 
-              << " terminado después de " << execution_time << "ms\n";
+    if (process->kill_requested.load()) {
+        std::cout << "[PROCESO " << process->pid << "] " << process->name << " terminado por kill\n";
+    } else {
+        std::cout << "[PROCESO " << process->pid << "] " << process->name 
+                  << " terminado después de " << execution_time << "ms\n";
+    }
     
-    // Liberar memoria del proceso
-    memory_manager.free(process->memory_address);
+    // Liberar la arena completa del proceso
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        release_process_memory(*process);
+    }
+    process->finished = true;
 }
 
 // Limpia procesos que ya terminaron
 void ProcessScheduler::cleanup_finished_processes() {
     auto it = running_processes.begin();
     while (it != running_processes.end()) {
-        if (it->second->thread_ptr && it->second->thread_ptr->joinable()) {
-            // Verificar si el hilo ha terminado (sin bloquear)
-            if (it->second->thread_ptr->get_id() == std::thread::id()) {
-                it = running_processes.erase(it);
-            } else {
-                ++it;
-            }
-        } else {
-            // El hilo ha terminado, hacer join y eliminar
-            if (it->second->thread_ptr) {
+        // Solo se hace join de hilos que ya terminaron, para no bloquear el scheduler
+        if (it->second->finished.load()) {
+            if (it->second->thread_ptr && it->second->thread_ptr->joinable()) {
                 it->second->thread_ptr->join();
             }
             it = running_processes.erase(it);
+        } else {
+            ++it;
         }
     }
 }
 
+// Devuelve la arena al MemoryManager con una sola llamada a free.
+// Sin arena el proceso deja de ser accesible por dirección y por PID
+void ProcessScheduler::release_process_memory(Process& process) {
+    if (process.arena && process.arena->release()) {
+        auto owner = arena_owners.find(process.memory_address);
+        if (owner != arena_owners.end() && owner->second.get() == &process) {
+            arena_owners.erase(owner);
+        }
+        auto live = live_processes.find(process.pid);
+        if (live != live_processes.end() && live->second.get() == &process) {
+            live_processes.erase(live);
+        }
+        memory_manager.free(process.memory_address);
+    }
+}
+
+// Las arenas vivas son disjuntas: solo puede contener 'addr' la de mayor base <= addr
+std::shared_ptr<Process> ProcessScheduler::find_arena_owner(size_t addr) const {
+    auto it = arena_owners.upper_bound(addr);
+    if (it == arena_owners.begin()) return nullptr;
+    --it;
+    return it->second->arena->contains(addr) ? it->second : nullptr;
+}
+
 // Muestra información de todos los procesos
-void ProcessScheduler::display_processes() const {
+void ProcessScheduler::display_processes(std::ostream& out) const {
     std::lock_guard<std::mutex> lock(scheduler_mutex);
     
-    std::cout << "\n=== Estado de Procesos ===\n";
-    std::cout << "Procesos en cola de listos: " << ready_queue.size() << "\n";
-    std::cout << "Procesos en ejecución: " << running_processes.size() << "\n";
+    out << "\n=== Estado de Procesos ===\n";
+    out << "Procesos en cola de listos: " << ready_queue.size() << "\n";
+    out << "Procesos en ejecución: " << running_processes.size() << "\n";
     
     if (!running_processes.empty()) {
-        std::cout << "\nProcesos en ejecución:\n";
-        std::cout << "PID\tNombre\t\tMemoria\t\tDirección\n";
-        std::cout << "------------------------------------------------\n";
+        out << "\nProcesos en ejecución:\n";
+        out << "PID\tNombre\t\tArena\tUsado\tAsign.\tDirección\tEstado\n";
+        out << "------------------------------------------------------------------------\n";
+        size_t total_arena = 0, total_used = 0;
         for (const auto& pair : running_processes) {
             const auto& proc = pair.second;
-            std::cout << proc->pid << "\t" << proc->name << "\t\t"
-                      << proc->memory_required << "\t\t" << proc->memory_address << "\n";
+            size_t used = 0, count = 0;
+            bool released = true;
+            if (proc->arena) {
+                proc->arena->get_stats(used, count, released);
+            }
+            if (!released) {
+                total_arena += proc->memory_required;
+                total_used += used;
+            }
+            out << proc->pid << "\t" << proc->name << "\t\t"
+                << proc->memory_required << "\t" << used << "\t" << count << "\t"
+                << proc->memory_address << "\t\t" << (released ? "TERMINANDO" : "EJECUTANDO") << "\n";
         }
+        out << "------------------------------------------------------------------------\n";
+        out << "Memoria en arenas: " << total_arena << " | Usada dentro de arenas: " << total_used << "\n";
     }
-    std::cout << "\n";
+    out << "\n";
+}
+
+// Recoge estadísticas de CPU sin retener el lock mientras se lee /proc.
+// La CPU de los hilos vivos se lee bajo el lock con su reloj de CPU: el lock impide
+// que cleanup_finished_processes o stop_scheduler hagan join del hilo a la vez
+std::vector<ProcessStats> ProcessScheduler::collect_process_stats() const {
+    struct Sample {
+        std::shared_ptr<Process> process;
+        bool has_clock;         // cpu_ns leído con pthread_getcpuclockid
+        uint64_t cpu_ns;
+    };
+    std::vector<Sample> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        snapshot.reserve(running_processes.size() + live_processes.size());
+        bool threads_alive = scheduler_running.load();
+        for (const auto& pair : running_processes) {
+            const auto& proc = pair.second;
+            Sample sample{proc, false, 0};
+            if (threads_alive && proc->thread_ptr && !proc->finished.load()) {
+                sample.has_clock = thread_cpu_ns(proc->thread_ptr->native_handle(), sample.cpu_ns);
+            }
+            snapshot.push_back(sample);
+        }
+        // Procesos aún en ready_queue: sin hilo todavía
+        for (const auto& pair : live_processes) {
+            if (!pair.second->thread_ptr) {
+                snapshot.push_back(Sample{pair.second, false, 0});
+            }
+        }
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    auto to_ms = [](std::chrono::steady_clock::duration d) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(d).count());
+    };
+    
+    std::vector<ProcessStats> result;
+    result.reserve(snapshot.size() + 1);
+    
+    pid_t sched_tid = scheduler_tid.load();
+    if (sched_tid != 0) {
+        ProcessStats stats{0, "[scheduler]", sched_tid, ThreadStats(), 0, 0};
+        read_thread_stats(sched_tid, stats.thread);
+        stats.wall_ms = to_ms(now - scheduler_started_at);
+        result.push_back(stats);
+    }
+    
+    for (const auto& sample : snapshot) {
+        const auto& proc = sample.process;
+        ProcessStats stats{proc->pid, proc->name, proc->tid.load(), ThreadStats(), 0, 0};
+        
+        int64_t started = proc->started_ns.load();
+        if (started != 0) {
+            auto started_at = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(started));
+            stats.ready_wait_ms = to_ms(started_at - proc->created_at);
+            stats.wall_ms = to_ms(now - started_at);
+        } else {
+            stats.ready_wait_ms = to_ms(now - proc->created_at);
+        }
+        
+        // CPU: reloj del hilo si se pudo leer; si no, schedstat; si el hilo ya terminó,
+        // la última muestra de CLOCK_THREAD_CPUTIME_ID que dejó el propio hilo
+        bool has_proc = stats.tid != 0 && !proc->finished.load() && read_thread_stats(stats.tid, stats.thread);
+        if (sample.has_clock) {
+            stats.thread.cpu_ns = sample.cpu_ns;
+        } else if (!has_proc) {
+            stats.thread.cpu_ns = proc->cpu_ns.load();
+        }
+        result.push_back(stats);
+    }
+    
+    return result;
 }
 
 // Termina un proceso específico por PID
 bool ProcessScheduler::terminate_process(int pid) {
     std::lock_guard<std::mutex> lock(scheduler_mutex);
     
-    auto it = running_processes.find(pid);
-    if (it != running_processes.end()) {
-        std::cout << "[SCHEDULER] Terminando proceso " << it->second->name 
+    // live_processes incluye los procesos aún en ready_queue
+    auto it = live_processes.find(pid);
+    if (it != live_processes.end() && !it->second->kill_requested.load()) {
+        auto process = it->second;
+        std::cout << "[SCHEDULER] Terminando proceso " << process->name 
                   << " (PID: " << pid << ")\n";
         
-        // Para este prototipo, simplemente esperamos a que termine naturalmente
-        if (it->second->thread_ptr && it->second->thread_ptr->joinable()) {
-            it->second->thread_ptr->join();
-        }
-        
-        memory_manager.free(it->second->memory_address);
-        running_processes.erase(it);
+        // Avisar al hilo y liberar su arena de inmediato; el hilo se recoge
+        // en cleanup_finished_processes cuando termine. Si sigue en cola,
+        // scheduler_loop lo descarta sin crearle hilo
+        process->kill_requested = true;
+        release_process_memory(*process);
         return true;
     }
     
     std::cout << "[SCHEDULER] Error: Proceso con PID " << pid << " no encontrado\n";
     return false;
-}
\ No newline at end of file
+}
+
+// Asigna memoria dentro de la arena de un proceso en cola o en ejecución
+size_t ProcessScheduler::alloc_in_process(int pid, size_t size) {
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    
+    auto it = live_processes.find(pid);
+    if (it == live_processes.end() || !it->second->arena) {
+        std::cout << "[SCHEDULER] Error: Proceso con PID " << pid << " no encontrado\n";
+        return MemoryManager::npos;
+    }
+    
+    size_t addr = it->second->arena->alloc(size);
+    if (addr == ProcessArena::npos) {
+        std::cout << "[SCHEDULER] Error: No hay espacio en la arena del proceso " << pid 
+                  << " para " << size << " bytes\n";
+        return MemoryManager::npos;
+    }
+    
+    std::cout << "[SCHEDULER] Asignados " << size << " bytes en la arena del proceso " << pid 
+              << " (dirección " << addr << ")\n";
+    return addr;
+}
+
+// Libera en la arena dueña de la dirección o, si no hay dueño, en el MemoryManager.
+// El free global también va bajo scheduler_mutex para que el bloque no pase a ser una
+// arena entre la búsqueda del dueño y la liberación
+bool ProcessScheduler::free_memory(size_t addr) {
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    
+    // Incluye procesos aún en ready_queue: su arena ya es suya
+    auto owner = find_arena_owner(addr);
+    if (owner) {
+        if (owner->arena->free(addr)) {
+            std::cout << "[SCHEDULER] Liberada la dirección " << addr 
+                      << " en la arena del proceso " << owner->pid << "\n";
+            return true;
+        }
+        std::cout << "[SCHEDULER] Error: La dirección " << addr 
+                  << " no es una asignación de la arena del proceso " << owner->pid << "\n";
+        return false;
+    }
+    
+    return memory_manager.free(addr);
+}
+
+// Libera varias direcciones: las de arenas bajo un solo lock del scheduler y el resto
+// con una sola llamada a MemoryManager::free_many
+size_t ProcessScheduler::free_memory_many(const std::vector<size_t>& addrs) {
+    size_t freed = 0;
+    std::vector<size_t> global;
+    global.reserve(addrs.size());
+    
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    
+    for (size_t addr : addrs) {
+        auto owner = find_arena_owner(addr);
+        if (owner) {
+            freed += owner->arena->free(addr) ? 1 : 0;
+        } else {
+            global.push_back(addr);
+        }
+    }
+    
+    if (!global.empty()) {
+        freed += memory_manager.free_many(global);
+    }
+    return freed;
+}
@@ -2,6 +2,8 @@
 #define PROCESS_SCHEDULER_H
 
 #include "MemoryManager.h"
+#include "ProcessArena.h"
+#include "ThreadStats.h"
 #include <thread>
 #include <queue>
 #include <mutex>
@@ -10,17 +12,40 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <map>
+#include <vector>
+#include <chrono>
 
 // Estructura que representa un proceso
 struct Process {
     int pid;                    // ID del proceso
     std::string name;           // Nombre del proceso
     size_t memory_required;     // Memoria requerida
-    size_t memory_address;      // Dirección de memoria asignada
+    size_t memory_address;      // Dirección de memoria asignada (base de la arena)
+    std::unique_ptr<ProcessArena> arena;      // Sub-arena para las asignaciones del proceso
     std::unique_ptr<std::thread> thread_ptr;  // Puntero al hilo del proceso
+    std::atomic<bool> kill_requested;         // kill pidió terminar el proceso
+    std::atomic<bool> finished;               // El hilo terminó y puede hacerse join
+    
+    std::chrono::steady_clock::time_point created_at;  // Momento en que entró a ready_queue
+    std::atomic<int64_t> started_ns;          // Inicio de ejecución (ns de steady_clock, 0 = en cola)
+    std::atomic<pid_t> tid;                   // TID del hilo del proceso (0 = sin hilo)
+    std::atomic<uint64_t> cpu_ns;             // CLOCK_THREAD_CPUTIME_ID muestreado por el propio hilo
     
     Process(int p, const std::string& n, size_t mem) 
-        : pid(p), name(n), memory_required(mem), memory_address(0) {}
+        : pid(p), name(n), memory_required(mem), memory_address(0),
+          kill_requested(false), finished(false),
+          created_at(std::chrono::steady_clock::now()), started_ns(0), tid(0), cpu_ns(0) {}
+};
+
+// Instantánea del uso de CPU de un proceso (o del hilo del scheduler) para 'top'
+struct ProcessStats {
+    int pid;                    // 0 para el hilo del scheduler
+    std::string name;
+    pid_t tid;
+    ThreadStats thread;         // Contadores de /proc/self/task/<tid>/
+    uint64_t wall_ms;           // Tiempo desde que empezó a ejecutarse
+    uint64_t ready_wait_ms;     // Tiempo que pasó en ready_queue
 };
 
 class ProcessScheduler {
@@ -28,6 +53,8 @@ private:
     MemoryManager& memory_manager;              // Referencia al gestor de memoria
     std::queue<std::shared_ptr<Process>> ready_queue;  // Cola de procesos listos (FCFS)
     std::unordered_map<int, std::shared_ptr<Process>> running_processes; // Procesos en ejecución
+    std::map<size_t, std::shared_ptr<Process>> arena_owners;  // Base de arena -> proceso (en cola o en ejecución)
+    std::unordered_map<int, std::shared_ptr<Process>> live_processes; // PID -> proceso con arena (en cola o en ejecución)
     
     mutable std::mutex scheduler_mutex;         // Mutex para acceso thread-safe al scheduler (mutable para const functions)
     std::condition_variable cv;                 // Variable de condición para sincronización
@@ -35,6 +62,11 @@ private:
     std::atomic<bool> scheduler_running;        // Flag para controlar el scheduler
     
     std::thread scheduler_thread;               // Hilo principal del scheduler
+    std::atomic<pid_t> scheduler_tid;           // TID del hilo del scheduler (para 'top')
+    std::chrono::steady_clock::time_point scheduler_started_at;
+    
+    int min_execution_ms;                       // Rango de duración simulada de los procesos
+    int max_execution_ms;
 
 public:
     // Constructor
@@ -46,17 +78,40 @@ public:
     // Crea un nuevo proceso y lo añade a la cola de listos
     int crear_proceso(const std::string& name, size_t memory_required);
     
+    // Crea varios procesos (nombre, memoria) en lote. Retorna un PID por petición (-1 si falla)
+    std::vector<int> crear_procesos(const std::vector<std::pair<std::string, size_t>>& batch);
+    
     // Inicia el scheduler
     void start_scheduler();
     
     // Para el scheduler
     void stop_scheduler();
     
-    // Muestra información de los procesos
-    void display_processes() const;
+    // Cambia el rango de duración simulada de los procesos (por defecto 1000-5000 ms).
+    // Debe llamarse antes de start_scheduler
+    void set_execution_time_range(int min_ms, int max_ms);
+    
+    // Muestra información de los procesos (por defecto en std::cout)
+    void display_processes(std::ostream& out = std::cout) const;
+    
+    // Recoge el uso de CPU de los procesos (en cola y en ejecución) y del scheduler.
+    // Bajo scheduler_mutex solo copia la lista y lee los relojes de CPU de los hilos;
+    // /proc se lee fuera del lock
+    std::vector<ProcessStats> collect_process_stats() const;
     
-    // Termina un proceso por PID
+    // Termina un proceso por PID (en cola o en ejecución)
     bool terminate_process(int pid);
+    
+    // Asigna memoria dentro de la arena del proceso 'pid', en cola o en ejecución
+    // (MemoryManager::npos si falla)
+    size_t alloc_in_process(int pid, size_t size);
+    
+    // Libera una dirección: dentro de la arena de un proceso si le pertenece,
+    // en el MemoryManager global en caso contrario
+    bool free_memory(size_t addr);
+    
+    // Versión en lote de free_memory. Retorna cuántas direcciones se liberaron
+    size_t free_memory_many(const std::vector<size_t>& addrs);
 
 private:
     // Función principal del scheduler (ejecuta algoritmo FCFS)
@@ -70,6 +125,16 @@ private:
     
     // Limpia procesos terminados
     void cleanup_finished_processes();
+    
+    // Devuelve la arena del proceso al MemoryManager (solo la primera vez) y la quita
+    // de arena_owners. Requiere scheduler_mutex
+    void release_process_memory(Process& process);
+    
+    // Proceso cuya arena contiene 'addr' (nullptr si ninguna). Requiere scheduler_mutex
+    std::shared_ptr<Process> find_arena_owner(size_t addr) const;
+    
+    // El microbenchmark (Benchmark.cpp) observa la cola y los procesos en ejecución
+    friend class ProcessSchedulerBench;
 };
 
 #endif // PROCESS_SCHEDULER_H
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "Shell.h"
+#include "CommandLine.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
 
 Shell::Shell(MemoryManager& mm, ProcessScheduler& ps) 
     : memory_manager(mm), process_scheduler(ps), running(false) {
@@ -29,9 +33,7 @@ void Shell::run() {
     std::cout << "Escribe help para ver los comandos disponibles.\n";
     std::cout << std::endl;
     
-    // Iniciar el scheduler
-    process_scheduler.start_scheduler();
-    
+    // El scheduler lo arranca y lo para main(), que también ordena el cierre del ControlServer
     std::string input;
     while (running) {
         show_prompt();
@@ -47,9 +49,6 @@ void Shell::run() {
             }
         }
     }
-    
-    // Parar el scheduler al salir
-    process_scheduler.stop_scheduler();
 }
 
 void Shell::stop() {
@@ -77,6 +76,8 @@ void Shell::process_command(const std::string& command) {
         cmd_mem(tokens);
     } else if (cmd == "kill") {
         cmd_kill(tokens);
+    } else if (cmd == "top") {
+        cmd_top(tokens);
     } else if (cmd == "help") {
         cmd_help(tokens);
     } else if (cmd == "clear") {
@@ -90,24 +91,13 @@ void Shell::process_command(const std::string& command) {
     }
 }
 
-// Divide una string en tokens
-std::vector<std::string> Shell::tokenize(const std::string& str) {
-    std::vector<std::string> tokens;
-    std::istringstream iss(str);
-    std::string token;
-    
-    while (iss >> token) {
-        tokens.push_back(token);
-    }
-    
-    return tokens;
-}
-
-// Comando: alloc <tamaño> - Asignar memoria
+// Comando: alloc <tamaño> [pid | x<N>] - Asignar memoria (global, en la arena de un proceso o en lote)
 void Shell::cmd_alloc(const std::vector<std::string>& args) {
-    if (args.size() != 2) {
-        std::cout << "[SHELL] Uso: alloc <tamaño_en_bytes>\n";
+    if (args.size() != 2 && args.size() != 3) {
+        std::cout << "[SHELL] Uso: alloc <tamaño_en_bytes> [pid | x<N>]\n";
         std::cout << "        Ejemplo: alloc 1024\n";
+        std::cout << "        Ejemplo: alloc 64 1   (dentro de la arena del proceso 1)\n";
+        std::cout << "        Ejemplo: alloc 64 x100   (100 bloques en lote)\n";
         return;
     }
     
@@ -118,8 +108,28 @@ void Shell::cmd_alloc(const std::vector<std::string>& args) {
             return;
         }
         
-        size_t addr = memory_manager.alloc(size);
-        if (addr != 0) {
+        size_t count;
+        if (args.size() == 3 && is_repeat_token(args[2])) {
+            if (!parse_repeat(args[2], count)) {
+                std::cout << "[SHELL] Error: Número de repeticiones inválido (x1 a x" << MAX_REPEAT << ")\n";
+                return;
+            }
+            std::vector<size_t> addrs = memory_manager.alloc_many(std::vector<size_t>(count, size));
+            size_t ok = std::count_if(addrs.begin(), addrs.end(), [](size_t a) { return a != MemoryManager::npos; });
+            std::cout << "[SHELL] " << ok << "/" << count << " bloques asignados";
+            if (ok > 0) {
+                auto first = std::find_if(addrs.begin(), addrs.end(), [](size_t a) { return a != MemoryManager::npos; });
+                std::cout << " (primera dirección: " << *first << ")";
+            }
+            std::cout << "\n";
+            return;
+        }
+        
+        // Con pid la memoria pertenece al proceso y se libera con él
+        size_t addr = (args.size() == 3)
+            ? process_scheduler.alloc_in_process(std::stoi(args[2]), size)
+            : memory_manager.alloc(size);
+        if (addr != MemoryManager::npos) {
             std::cout << "[SHELL] Memoria asignada exitosamente en dirección: " << addr << "\n";
         }
     } catch (const std::exception& e) {
@@ -127,11 +137,18 @@ void Shell::cmd_alloc(const std::vector<std::string>& args) {
     }
 }
 
-// Comando: exec <nombre> <memoria> - Ejecutar proceso
+// Comando: exec <nombre> <memoria> [x<N>] - Ejecutar proceso (o N procesos en lote)
 void Shell::cmd_exec(const std::vector<std::string>& args) {
-    if (args.size() != 3) {
-        std::cout << "[SHELL] Uso: exec <nombre_proceso> <memoria_requerida>\n";
+    size_t count = 1;
+    if ((args.size() != 3 && args.size() != 4) ||
+        (args.size() == 4 && !is_repeat_token(args[3]))) {
+        std::cout << "[SHELL] Uso: exec <nombre_proceso> <memoria_requerida> [x<N>]\n";
         std::cout << "        Ejemplo: exec calculadora 512\n";
+        std::cout << "        Ejemplo: exec worker 256 x1000   (1000 procesos en lote)\n";
+        return;
+    }
+    if (args.size() == 4 && !parse_repeat(args[3], count)) {
+        std::cout << "[SHELL] Error: Número de repeticiones inválido (x1 a x" << MAX_REPEAT << ")\n";
         return;
     }
     
@@ -144,6 +161,19 @@ void Shell::cmd_exec(const std::vector<std::string>& args) {
             return;
         }
         
+        if (args.size() == 4) {
+            std::vector<int> pids = process_scheduler.crear_procesos(
+                std::vector<std::pair<std::string, size_t>>(count, {name, memory}));
+            std::vector<int> created;
+            std::copy_if(pids.begin(), pids.end(), std::back_inserter(created), [](int p) { return p > 0; });
+            std::cout << "[SHELL] " << created.size() << "/" << count << " procesos '" << name << "' creados";
+            if (!created.empty()) {
+                std::cout << " (PIDs " << created.front() << "-" << created.back() << ")";
+            }
+            std::cout << "\n";
+            return;
+        }
+        
         int pid = process_scheduler.crear_proceso(name, memory);
         if (pid > 0) {
             std::cout << "[SHELL] Proceso '" << name << "' creado con PID: " << pid << "\n";
@@ -153,17 +183,28 @@ void Shell::cmd_exec(const std::vector<std::string>& args) {
     }
 }
 
-// Comando: free <dirección> - Liberar memoria
+// Comando: free <dirección> [<dirección> ...] - Liberar memoria
 void Shell::cmd_free(const std::vector<std::string>& args) {
-    if (args.size() != 2) {
-        std::cout << "[SHELL] Uso: free <dirección_memoria>\n";
+    if (args.size() < 2) {
+        std::cout << "[SHELL] Uso: free <dirección_memoria> [<dirección_memoria> ...]\n";
         std::cout << "        Ejemplo: free 0\n";
+        std::cout << "        Ejemplo: free 0 64 128   (liberación en lote)\n";
         return;
     }
     
     try {
+        if (args.size() > 2) {
+            std::vector<size_t> addrs;
+            for (size_t i = 1; i < args.size(); ++i) {
+                addrs.push_back(std::stoull(args[i]));
+            }
+            size_t freed = process_scheduler.free_memory_many(addrs);
+            std::cout << "[SHELL] " << freed << "/" << addrs.size() << " bloques liberados\n";
+            return;
+        }
+        
         size_t addr = std::stoull(args[1]);
-        if (memory_manager.free(addr)) {
+        if (process_scheduler.free_memory(addr)) {
             std::cout << "[SHELL] Memoria liberada exitosamente\n";
         }
     } catch (const std::exception& e) {
@@ -199,22 +240,110 @@ void Shell::cmd_kill(const std::vector<std::string>& args) {
     }
 }
 
+// Comando: top [refrescos] [intervalo_ms] - Uso de CPU por proceso
+void Shell::cmd_top(const std::vector<std::string>& args) {
+    if (args.size() > 3) {
+        std::cout << "[SHELL] Uso: top [refrescos] [intervalo_ms]\n";
+        std::cout << "        Ejemplo: top 5 1000\n";
+        return;
+    }
+    
+    int refreshes = 5;
+    int interval_ms = 1000;
+    try {
+        if (args.size() >= 2) refreshes = std::stoi(args[1]);
+        if (args.size() == 3) interval_ms = std::stoi(args[2]);
+    } catch (const std::exception& e) {
+        std::cout << "[SHELL] Error: Argumentos inválidos\n";
+        return;
+    }
+    if (refreshes < 1 || interval_ms < 100) {
+        std::cout << "[SHELL] Error: refrescos >= 1 e intervalo >= 100 ms\n";
+        return;
+    }
+    
+    // CPU de la muestra anterior por PID (los procesos en cola aún no tienen TID),
+    // para calcular %CPU en cada intervalo
+    std::unordered_map<int, uint64_t> previous_cpu;
+    
+    for (int frame = 0; frame < refreshes; ++frame) {
+        std::vector<ProcessStats> stats = process_scheduler.collect_process_stats();
+        
+        // %CPU de cada hilo. Primer refresco: CPU acumulada / tiempo de pared; después, delta del intervalo
+        std::vector<std::pair<double, const ProcessStats*>> rows;
+        std::unordered_map<int, uint64_t> current_cpu;
+        for (const auto& s : stats) {
+            double percent = 0.0;
+            auto prev = previous_cpu.find(s.pid);
+            if (prev != previous_cpu.end() && s.thread.cpu_ns >= prev->second) {
+                percent = 100.0 * (s.thread.cpu_ns - prev->second) / (interval_ms * 1e6);
+            } else if (s.wall_ms > 0) {
+                percent = 100.0 * s.thread.cpu_ns / (s.wall_ms * 1e6);
+            }
+            current_cpu[s.pid] = s.thread.cpu_ns;
+            rows.emplace_back(percent, &s);
+        }
+        
+        // Ordenar por %CPU del intervalo (lo que está ocupado ahora), desempate por CPU acumulada
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+            if (a.first != b.first) return a.first > b.first;
+            return a.second->thread.cpu_ns > b.second->thread.cpu_ns;
+        });
+        
+        std::cout << "\033[2J\033[1;1H";
+        std::cout << "=== top (" << frame + 1 << "/" << refreshes << ", cada " 
+                  << interval_ms << " ms) ===\n";
+        std::cout << std::left << std::setw(6) << "PID" << std::setw(14) << "Nombre"
+                  << std::right << std::setw(8) << "TID" << std::setw(8) << "%CPU"
+                  << std::setw(11) << "CPU(ms)" << std::setw(9) << "Usr(ms)" << std::setw(9) << "Sys(ms)"
+                  << std::setw(11) << "Pared(ms)" << std::setw(11) << "Cola(ms)" << std::setw(11) << "Kernel(ms)"
+                  << std::setw(8) << "CtxV" << std::setw(8) << "CtxI" << "\n";
+        std::cout << std::string(114, '-') << "\n";
+        
+        for (const auto& row : rows) {
+            double percent = row.first;
+            const ProcessStats& s = *row.second;
+            std::cout << std::left << std::setw(6) << s.pid << std::setw(14) << s.name.substr(0, 13)
+                      << std::right << std::setw(8) << s.tid
+                      << std::setw(8) << std::fixed << std::setprecision(1) << percent
+                      << std::setw(11) << std::setprecision(2) << s.thread.cpu_ns / 1e6
+                      << std::setw(9) << s.thread.user_ms << std::setw(9) << s.thread.system_ms
+                      << std::setw(11) << s.wall_ms << std::setw(11) << s.ready_wait_ms
+                      << std::setw(11) << s.thread.run_queue_wait_ns / 1000000
+                      << std::setw(8) << s.thread.voluntary_switches
+                      << std::setw(8) << s.thread.involuntary_switches << "\n";
+        }
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << std::left << std::setprecision(6);
+        std::cout << "\nCola(ms): espera en ready_queue | Kernel(ms): espera por CPU en el kernel\n";
+        std::cout << std::flush;
+        
+        previous_cpu.swap(current_cpu);
+        if (frame + 1 < refreshes) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        }
+    }
+}
+
 // Comando: help - Mostrar ayuda
 void Shell::cmd_help(const std::vector<std::string>& /*args*/) {
     std::cout << "\n=== COMANDOS DISPONIBLES ===\n";
     std::cout << std::left;
-    std::cout << std::setw(25) << "alloc <tamaño>" << "Asignar memoria\n";
-    std::cout << std::setw(25) << "exec <nombre> <memoria>" << "Crear y ejecutar proceso\n";
-    std::cout << std::setw(25) << "free <dirección>" << "Liberar bloque de memoria\n";
+    std::cout << std::setw(25) << "alloc <tamaño> [pid|xN]" << "Asignar memoria (en la arena de pid, o N bloques en lote)\n";
+    std::cout << std::setw(25) << "exec <nombre> <mem> [xN]" << "Crear y ejecutar proceso (N en lote)\n";
+    std::cout << std::setw(25) << "free <dirección> [...]" << "Liberar uno o varios bloques de memoria\n";
     std::cout << std::setw(25) << "ps" << "Mostrar procesos en ejecución\n";
     std::cout << std::setw(25) << "mem" << "Mostrar estado de memoria\n";
     std::cout << std::setw(25) << "kill <pid>" << "Terminar proceso\n";
+    std::cout << std::setw(25) << "top [n] [intervalo_ms]" << "Uso de CPU por proceso (n refrescos)\n";
     std::cout << std::setw(25) << "clear" << "Limpiar pantalla\n";
     std::cout << std::setw(25) << "help" << "Mostrar esta ayuda\n";
     std::cout << std::setw(25) << "exit/quit" << "Salir del sistema\n";
     std::cout << "\nEjemplos:\n";
     std::cout << "  alloc 1024          # Asignar 1024 bytes\n";
+    std::cout << "  alloc 64 1          # Asignar 64 bytes en la arena del proceso 1\n";
     std::cout << "  exec editor 512     # Crear proceso 'editor' con 512 bytes\n";
+    std::cout << "  exec worker 16 x100 # Crear 100 procesos 'worker' en lote\n";
     std::cout << "  free 0              # Liberar memoria en dirección 0\n";
     std::cout << "  kill 1              # Terminar proceso con PID 1\n\n";
 }
@@ -29,8 +29,6 @@ private:
     // Procesa un comando ingresado por el usuario
     void process_command(const std::string& command);
     
-    // Divide una línea de comando en tokens
-    std::vector<std::string> tokenize(const std::string& str);
     
     // Comandos específicos
     void cmd_alloc(const std::vector<std::string>& args);
@@ -39,6 +37,7 @@ private:
     void cmd_ps(const std::vector<std::string>& args);
     void cmd_mem(const std::vector<std::string>& args);
     void cmd_kill(const std::vector<std::string>& args);
+    void cmd_top(const std::vector<std::string>& args);
     void cmd_help(const std::vector<std::string>& args);
     void cmd_clear(const std::vector<std::string>& args);
     
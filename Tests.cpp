@@ -0,0 +1,419 @@
+// Comprobaciones de corrección del simulador (make test)
+//
+// Cada caso imprime [OK] o [FALLO]; el programa termina con código 1 si algún caso falla.
+
+#include "CommandLine.h"
+#include "BitmapAllocator.h"
+#include "MemoryManager.h"
+#include "ProcessArena.h"
+#include "ProcessScheduler.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+
+// Acceso a los kernels y mapas de bits de BitmapAllocator (amigo de la clase)
+class BitmapAllocatorTest {
+public:
+    static void force_scalar(BitmapAllocator& bitmap) {
+        bitmap.scan_words = BitmapAllocator::scalar_kernel();
+    }
+
+    static size_t scan_selected(const BitmapAllocator& bitmap, const std::vector<uint64_t>& words,
+                                size_t from, uint64_t pattern) {
+        return bitmap.scan_words(words.data(), from, words.size(), pattern);
+    }
+
+    static size_t scan_scalar(const std::vector<uint64_t>& words, size_t from, uint64_t pattern) {
+        return BitmapAllocator::scalar_kernel()(words.data(), from, words.size(), pattern);
+    }
+
+    static uint64_t used_word(const BitmapAllocator& bitmap, size_t w) { return bitmap.used_bits[w]; }
+    static uint64_t run_end_word(const BitmapAllocator& bitmap, size_t w) { return bitmap.run_end_bits[w]; }
+};
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& description) {
+    std::cout << (condition ? "[OK]    " : "[FALLO] ") << description << "\n";
+    if (!condition) failures++;
+}
+
+// Silencia los mensajes de MemoryManager/ProcessScheduler mientras existe
+struct QuietOutput {
+    QuietOutput() { std::cout.setstate(std::ios::badbit); }
+    ~QuietOutput() { std::cout.clear(); }
+};
+
+// --- BitmapAllocator ---
+
+// Tamaños enormes no pueden desbordar el redondeo a unidades
+void test_bitmap_rejects_oversized() {
+    BitmapAllocator bitmap(8192, 16);
+    check(bitmap.alloc(static_cast<size_t>(-1)) == BitmapAllocator::npos, "bitmap: alloc(SIZE_MAX) retorna npos");
+    check(bitmap.alloc(static_cast<size_t>(-1) - 8) == BitmapAllocator::npos, "bitmap: alloc(SIZE_MAX - 8) retorna npos");
+    check(bitmap.alloc(8193) == BitmapAllocator::npos, "bitmap: alloc mayor que la capacidad retorna npos");
+    check(bitmap.alloc(0) == BitmapAllocator::npos, "bitmap: alloc(0) retorna npos");
+    check(bitmap.used_bytes() == 0, "bitmap: las peticiones rechazadas no ocupan unidades");
+    check(bitmap.alloc(8192) == 0, "bitmap: alloc de la capacidad exacta");
+}
+
+// El kernel elegido para la CPU (AVX2/SSE4.1) debe dar el mismo resultado que el escalar
+// para cualquier longitud, posición de inicio y posición de la primera palabra distinta
+void test_bitmap_kernels_match_scalar() {
+    BitmapAllocator bitmap(1024, 16);
+    bool all_match = true;
+    for (uint64_t pattern : {uint64_t(0), ~uint64_t(0)}) {
+        for (size_t n = 0; n <= 13; ++n) {
+            // diff == n: todas las palabras iguales al patrón
+            for (size_t diff = 0; diff <= n; ++diff) {
+                std::vector<uint64_t> words(n, pattern);
+                if (diff < n) words[diff] = pattern ^ (uint64_t(1) << (diff % 64));
+                for (size_t from = 0; from <= n; ++from) {
+                    size_t expected = BitmapAllocatorTest::scan_scalar(words, from, pattern);
+                    all_match &= BitmapAllocatorTest::scan_selected(bitmap, words, from, pattern) == expected;
+                    all_match &= expected == (diff >= from ? diff : n);
+                }
+            }
+        }
+    }
+    check(all_match, std::string("bitmap: kernel ") + BitmapAllocator::kernel_name() + " coincide con el escalar");
+}
+
+// Las unidades de relleno de la última palabra nunca se asignan ni cuentan como usadas
+void test_bitmap_tail_padding() {
+    BitmapAllocator bitmap(100 * 16, 16);  // 100 unidades: 36 bits de relleno en la segunda palabra
+    check(bitmap.used_bytes() == 0, "bitmap: el relleno final no cuenta como usado");
+    check(bitmap.alloc(99 * 16) == 0, "bitmap: 99 de 100 unidades asignadas");
+    check(bitmap.alloc(32) == BitmapAllocator::npos, "bitmap: una región no puede entrar en el relleno");
+    check(bitmap.alloc(16) == 99 * 16, "bitmap: la última unidad real sí se asigna");
+    check(bitmap.free(0) == 99 * 16 && bitmap.free(99 * 16) == 16, "bitmap: liberación de ambas regiones");
+    check(BitmapAllocatorTest::used_word(bitmap, 1) == (~uint64_t(0) << 36), "bitmap: los bits de relleno siguen a 1");
+}
+
+// run_end_bits separa regiones ocupadas contiguas; free solo acepta el inicio de una región
+void test_bitmap_adjacent_runs() {
+    BitmapAllocator bitmap(4096, 16);
+    size_t a = bitmap.alloc(32);   // unidades 0-1
+    size_t b = bitmap.alloc(48);   // unidades 2-4
+    size_t c = bitmap.alloc(60 * 16);  // unidades 5-64: cruza la frontera de palabra
+    check(a == 0 && b == 32 && c == 80, "bitmap: regiones contiguas asignadas en orden");
+    check(BitmapAllocatorTest::run_end_word(bitmap, 0) == ((uint64_t(1) << 1) | (uint64_t(1) << 4)) &&
+          BitmapAllocatorTest::run_end_word(bitmap, 1) == 1,
+          "bitmap: run_end_bits marca la última unidad de cada región");
+
+    std::vector<Block> runs = bitmap.decode_runs();
+    check(runs.size() == 4 &&
+          runs[0].start_addr == 0 && runs[0].size == 32 && !runs[0].is_free &&
+          runs[1].start_addr == 32 && runs[1].size == 48 && !runs[1].is_free &&
+          runs[2].start_addr == 80 && runs[2].size == 960 && !runs[2].is_free &&
+          runs[3].start_addr == 1040 && runs[3].is_free,
+          "bitmap: decode_runs separa regiones ocupadas contiguas");
+
+    check(bitmap.free(16) == 0, "bitmap: free en mitad de una región falla");
+    check(bitmap.free(b + 16) == 0, "bitmap: free en mitad de la segunda región falla");
+    check(bitmap.free(40) == 0, "bitmap: free no alineado a la unidad falla");
+    check(bitmap.free(b) == 48, "bitmap: free del inicio de la región central");
+    check(bitmap.free(b) == 0, "bitmap: doble free falla");
+    check(bitmap.free(c) == 960 && bitmap.free(a) == 32 && bitmap.used_bytes() == 0,
+          "bitmap: liberar el resto deja el mapa vacío");
+    check(BitmapAllocatorTest::run_end_word(bitmap, 0) == 0 && BitmapAllocatorTest::run_end_word(bitmap, 1) == 0,
+          "bitmap: run_end_bits queda limpio");
+}
+
+// Secuencia aleatoria de alloc/free: el mapa de bits con el kernel elegido, con el kernel
+// escalar y el First-Fit de lista de bloques (tamaños múltiplos de la unidad) deben coincidir
+void test_bitmap_matches_first_fit() {
+    const size_t heap = 64 << 10;
+    BitmapAllocator selected(heap, 16);
+    BitmapAllocator scalar(heap, 16);
+    BitmapAllocatorTest::force_scalar(scalar);
+    MemoryManager reference(heap);
+
+    std::mt19937 rng(12345);
+    std::vector<size_t> live;
+    bool same_addrs = true, same_frees = true;
+    {
+        QuietOutput quiet;
+        for (int op = 0; op < 5000; ++op) {
+            if (live.empty() || rng() % 3 != 0) {
+                size_t size = 16 * (1 + rng() % 40);
+                size_t expected = reference.alloc(size);
+                size_t got = selected.alloc(size);
+                same_addrs &= got == expected && scalar.alloc(size) == expected;
+                if (got != BitmapAllocator::npos) live.push_back(got);
+            } else {
+                size_t index = rng() % live.size();
+                size_t addr = live[index];
+                live[index] = live.back();
+                live.pop_back();
+                bool freed = reference.free(addr);
+                same_frees &= freed && selected.free(addr) > 0 && scalar.free(addr) > 0;
+            }
+        }
+    }
+    check(same_addrs, "bitmap: mismas direcciones que First-Fit de lista (kernel elegido y escalar)");
+    check(same_frees, "bitmap: las liberaciones coinciden con First-Fit de lista");
+
+    size_t total, used, free;
+    reference.get_memory_stats(total, used, free);
+    check(selected.used_bytes() == used && scalar.used_bytes() == used, "bitmap: mismos bytes ocupados que la lista");
+}
+
+// Hueco a hueco de distintos tamaños: 48 bloques y se libera uno de cada tres
+std::vector<size_t> fragment(MemoryManager& mm) {
+    std::vector<size_t> blocks;
+    for (size_t i = 0; i < 48; ++i) {
+        blocks.push_back(mm.alloc(16 * (1 + (i * 7) % 11)));
+    }
+    for (size_t i = 0; i < blocks.size(); i += 3) {
+        mm.free(blocks[i]);
+    }
+    return blocks;
+}
+
+std::string memory_map(const MemoryManager& mm) {
+    std::ostringstream out;
+    mm.display_memory(out);
+    return out.str();
+}
+
+// alloc_many debe colocar cada bloque donde lo pondría una serie de alloc, con ambos backends
+void test_alloc_many_matches_sequential(size_t unit_size, const std::string& backend) {
+    // Tamaños repetidos (cursor), crecientes, decrecientes, 0 y mayores que el heap
+    const std::vector<size_t> sizes = {32, 32, 32, 48, 48, 16, 16, 0, 160, 64, 1 << 20, 32, 16, 16, 112, 112};
+    MemoryManager batch(4096, unit_size);
+    MemoryManager sequential(4096, unit_size);
+    std::vector<size_t> batch_addrs, sequential_addrs;
+    {
+        QuietOutput quiet;
+        fragment(batch);
+        fragment(sequential);
+        batch_addrs = batch.alloc_many(sizes);
+        for (size_t size : sizes) {
+            sequential_addrs.push_back(sequential.alloc(size));
+        }
+    }
+    check(batch_addrs == sequential_addrs, backend + ": alloc_many da las mismas direcciones que alloc uno a uno");
+    check(memory_map(batch) == memory_map(sequential), backend + ": alloc_many deja el mismo mapa de memoria");
+    check(batch_addrs[7] == MemoryManager::npos && batch_addrs[10] == MemoryManager::npos,
+          backend + ": alloc_many rechaza tamaño 0 y mayor que el heap");
+}
+
+// free_many ignora direcciones repetidas, desconocidas o en mitad de un bloque
+void test_free_many_duplicates_and_unknown(size_t unit_size, const std::string& backend) {
+    MemoryManager mm(4096, unit_size);
+    size_t freed, total, used, free;
+    bool refree;
+    {
+        QuietOutput quiet;
+        size_t a = mm.alloc(64);
+        size_t b = mm.alloc(128);
+        size_t c = mm.alloc(32);
+        mm.alloc(48);
+        freed = mm.free_many({c, a, a, b + 16, 100000, MemoryManager::npos, c, b});
+        refree = mm.free(a) || mm.free(b) || mm.free(c);
+        mm.get_memory_stats(total, used, free);
+    }
+    check(freed == 3, backend + ": free_many cuenta cada bloque una sola vez");
+    check(!refree, backend + ": los bloques liberados en lote ya no se pueden liberar");
+    check(used == 48, backend + ": free_many no toca bloques no pedidos");
+}
+
+// Con el cursor, peticiones iguales continúan tras la región anterior en vez de desde la unidad 0
+void test_bitmap_cursor_continues() {
+    BitmapAllocator bitmap(64 * 16, 16);
+    BitmapAllocator reference(64 * 16, 16);
+    for (size_t unit = 0; unit < 64; ++unit) {
+        bitmap.alloc(16);
+        reference.alloc(16);
+    }
+    // Huecos de 1, 2, 3 y 4 unidades
+    for (size_t unit : {1, 5, 6, 10, 11, 12, 20, 21, 22, 23}) {
+        bitmap.free(unit * 16);
+        reference.free(unit * 16);
+    }
+
+    BitmapAllocator::Cursor cursor;
+    size_t first = bitmap.alloc(48, cursor);
+    check(first == 10 * 16 && first == reference.alloc(48) && cursor.unit == 13,
+          "bitmap: el cursor queda tras la región asignada");
+    size_t second = bitmap.alloc(48, cursor);
+    check(second == 20 * 16 && second == reference.alloc(48), "bitmap: una petición igual continúa desde el cursor");
+    check(bitmap.alloc(64, cursor) == BitmapAllocator::npos && cursor.unit == 64,
+          "bitmap: tras un fallo el cursor descarta peticiones iguales o mayores");
+    check(bitmap.alloc(32, cursor) == 5 * 16 && reference.alloc(32) == 5 * 16,
+          "bitmap: una petición menor vuelve a buscar desde el inicio");
+}
+
+// --- ProcessArena ---
+
+// Dos huecos contiguos bajo 'bump' deben fusionarse para servir una petición mayor
+void test_arena_merges_adjacent_holes() {
+    ProcessArena arena(1000, 64);
+    size_t a = arena.alloc(16);
+    size_t b = arena.alloc(16);
+    size_t c = arena.alloc(16);
+    check(a == 1000 && b == 1016 && c == 1032, "arena: asignaciones bump consecutivas");
+
+    arena.free(a);
+    arena.free(b);
+    check(arena.alloc(32) == 1000, "arena: huecos contiguos fusionados sirven alloc(32)");
+}
+
+// El orden de liberación no importa: el hueco del medio une a sus dos vecinos
+void test_arena_merges_both_neighbours() {
+    ProcessArena arena(0, 64);
+    size_t a = arena.alloc(16);
+    size_t b = arena.alloc(16);
+    size_t c = arena.alloc(16);
+    arena.alloc(16);  // Mantiene los huecos por debajo de la cima
+
+    arena.free(c);
+    arena.free(a);
+    arena.free(b);
+    check(arena.alloc(48) == 0, "arena: hueco central fusionado con ambos vecinos");
+}
+
+// Liberar la cima absorbe los huecos que quedan debajo y devuelve toda la capacidad
+void test_arena_bump_absorbs_holes() {
+    ProcessArena arena(0, 64);
+    size_t a = arena.alloc(16);
+    size_t b = arena.alloc(16);
+    size_t c = arena.alloc(16);
+
+    arena.free(a);
+    arena.free(b);
+    arena.free(c);
+
+    size_t used, count;
+    bool released;
+    arena.get_stats(used, count, released);
+    check(used == 0 && count == 0, "arena: sin asignaciones tras liberar todo");
+    check(arena.alloc(64) == 0, "arena: capacidad completa disponible tras liberar todo");
+}
+
+void test_arena_rejects_invalid_frees() {
+    ProcessArena arena(100, 32);
+    size_t a = arena.alloc(8);
+    check(!arena.free(a + 4), "arena: free en mitad de una asignación falla");
+    check(arena.free(a), "arena: free de una asignación válida");
+    check(!arena.free(a), "arena: doble free falla");
+    check(arena.alloc(64) == ProcessArena::npos, "arena: alloc mayor que la capacidad retorna npos");
+
+    ProcessArena huge(64, static_cast<size_t>(-1) - 32);
+    check(!huge.contains(16), "arena: contains no desborda con capacidades enormes");
+}
+
+// --- ProcessScheduler ---
+
+// Un proceso en ready_queue ya es dueño de su arena: free no puede devolverla al MemoryManager
+void test_scheduler_protects_queued_arenas() {
+    MemoryManager mm(1024);
+    ProcessScheduler ps(mm);  // Sin start_scheduler: los procesos se quedan en cola
+    size_t total, used, free;
+    bool freed_base, freed_batch, freed_global;
+    {
+        QuietOutput quiet;
+        ps.crear_proceso("a", 64);
+        ps.crear_proceso("b", 64);
+        freed_base = ps.free_memory(0);
+        freed_batch = ps.free_memory_many({0, 64}) > 0;
+        size_t global = mm.alloc(32);
+        freed_global = ps.free_memory(global);
+        mm.get_memory_stats(total, used, free);
+    }
+    check(!freed_base, "scheduler: free de la base de una arena en cola falla");
+    check(!freed_batch, "scheduler: free en lote no libera arenas en cola");
+    check(freed_global, "scheduler: free de un bloque global fuera de arenas");
+    check(used == 128, "scheduler: las arenas en cola siguen asignadas");
+}
+
+// kill y alloc en un proceso encuentran también a los procesos que siguen en ready_queue
+void test_scheduler_reaches_queued_processes() {
+    MemoryManager mm(1024);
+    ProcessScheduler ps(mm);  // Sin start_scheduler: los procesos se quedan en cola
+    size_t total, used, free;
+    size_t inner;
+    bool killed, killed_again;
+    size_t alloc_after_kill;
+    {
+        QuietOutput quiet;
+        int a = ps.crear_proceso("a", 64);
+        std::vector<int> batch = ps.crear_procesos({{"b", 128}, {"c", 32}});
+        inner = ps.alloc_in_process(batch[0], 48);
+        killed = ps.terminate_process(a) && ps.terminate_process(batch[0]);
+        killed_again = ps.terminate_process(a);
+        alloc_after_kill = ps.alloc_in_process(batch[0], 16);
+        mm.get_memory_stats(total, used, free);
+    }
+    check(inner == 64, "scheduler: alloc dentro de la arena de un proceso en cola");
+    check(killed, "scheduler: kill de procesos en cola (individual y de lote)");
+    check(!killed_again, "scheduler: segundo kill del mismo proceso falla");
+    check(alloc_after_kill == MemoryManager::npos, "scheduler: alloc en un proceso terminado falla");
+    check(used == 32, "scheduler: kill en cola devuelve la arena");
+}
+
+// top muestra también los procesos en cola: sin hilo, esperando desde que se crearon
+void test_stats_include_queued_processes() {
+    MemoryManager mm(1024);
+    ProcessScheduler ps(mm);
+    std::vector<ProcessStats> stats;
+    {
+        QuietOutput quiet;
+        ps.crear_proceso("a", 64);
+        ps.crear_procesos({{"b", 64}, {"c", 64}});
+        stats = ps.collect_process_stats();
+    }
+    bool queued = stats.size() == 3;
+    for (const auto& s : stats) {
+        queued &= s.pid >= 1 && s.pid <= 3 && s.tid == 0 && s.wall_ms == 0 && s.thread.cpu_ns == 0;
+    }
+    check(queued, "scheduler: collect_process_stats incluye los procesos en cola");
+}
+
+// --- CommandLine ---
+
+void test_parse_repeat() {
+    size_t count = 0;
+    check(parse_repeat("x1000", count) && count == 1000, "comandos: x1000 son 1000 repeticiones");
+    check(parse_repeat("X1", count) && count == 1, "comandos: X1 en mayúscula");
+    check(!parse_repeat("x0", count), "comandos: x0 inválido");
+    check(!parse_repeat("x100001", count), "comandos: x100001 supera el máximo");
+    check(!parse_repeat("x99999999999999999999", count), "comandos: x con desbordamiento inválido");
+    check(!parse_repeat("x12a", count) && is_repeat_token("x12a"), "comandos: x12a es un lote mal formado");
+    check(!is_repeat_token("12"), "comandos: un número no es un sufijo de lote");
+}
+
+} // namespace
+
+int main() {
+    test_bitmap_rejects_oversized();
+    test_bitmap_kernels_match_scalar();
+    test_bitmap_tail_padding();
+    test_bitmap_adjacent_runs();
+    test_bitmap_matches_first_fit();
+    test_bitmap_cursor_continues();
+    test_alloc_many_matches_sequential(0, "lista");
+    test_alloc_many_matches_sequential(16, "bitmap");
+    test_free_many_duplicates_and_unknown(0, "lista");
+    test_free_many_duplicates_and_unknown(16, "bitmap");
+    test_arena_merges_adjacent_holes();
+    test_arena_merges_both_neighbours();
+    test_arena_bump_absorbs_holes();
+    test_arena_rejects_invalid_frees();
+    test_scheduler_protects_queued_arenas();
+    test_scheduler_reaches_queued_processes();
+    test_stats_include_queued_processes();
+    test_parse_repeat();
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " comprobaciones fallidas\n";
+        return 1;
+    }
+    std::cout << "\nTodas las comprobaciones pasaron\n";
+    return 0;
+}
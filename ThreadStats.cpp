@@ -0,0 +1,69 @@
+#include "ThreadStats.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+pid_t current_thread_id() {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+uint64_t current_thread_cpu_ns() {
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool thread_cpu_ns(pthread_t thread, uint64_t& cpu_ns) {
+    clockid_t clock;
+    timespec ts{};
+    if (pthread_getcpuclockid(thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) return false;
+    cpu_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    return true;
+}
+
+bool read_thread_stats(pid_t tid, ThreadStats& stats) {
+    const std::string dir = "/proc/self/task/" + std::to_string(tid) + "/";
+
+    // stat: el nombre va entre paréntesis y puede tener espacios; se parsea tras el último ')'
+    std::ifstream stat_file(dir + "stat");
+    std::string line;
+    if (!stat_file || !std::getline(stat_file, line)) return false;
+
+    size_t close_paren = line.rfind(')');
+    if (close_paren == std::string::npos) return false;
+
+    std::istringstream fields(line.substr(close_paren + 2));
+    std::string field;
+    uint64_t utime = 0, stime = 0;
+    // Campos desde 'state' (3): utime es el 14 y stime el 15
+    for (int index = 3; index <= 15 && fields >> field; ++index) {
+        if (index == 14) utime = std::stoull(field);
+        if (index == 15) stime = std::stoull(field);
+    }
+    long ticks = sysconf(_SC_CLK_TCK);
+    if (ticks <= 0) ticks = 100;
+    stats.user_ms = utime * 1000 / static_cast<uint64_t>(ticks);
+    stats.system_ms = stime * 1000 / static_cast<uint64_t>(ticks);
+
+    // schedstat: tiempo en CPU (ns), tiempo esperando en la cola del kernel (ns), timeslices
+    std::ifstream sched_file(dir + "schedstat");
+    if (!(sched_file >> stats.cpu_ns >> stats.run_queue_wait_ns)) {
+        // Kernel sin schedstat: aproximar con utime + stime
+        stats.cpu_ns = (stats.user_ms + stats.system_ms) * 1000000ULL;
+        stats.run_queue_wait_ns = 0;
+    }
+
+    // status: cambios de contexto voluntarios e involuntarios
+    std::ifstream status_file(dir + "status");
+    while (std::getline(status_file, line)) {
+        if (line.compare(0, 24, "voluntary_ctxt_switches:") == 0) {
+            stats.voluntary_switches = std::stoull(line.substr(24));
+        } else if (line.compare(0, 27, "nonvoluntary_ctxt_switches:") == 0) {
+            stats.involuntary_switches = std::stoull(line.substr(27));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef THREAD_STATS_H
+#define THREAD_STATS_H
+
+#include <cstdint>
+#include <pthread.h>
+#include <sys/types.h>
+
+// Contadores de un hilo del sistema leídos de /proc/self/task/<tid>/
+struct ThreadStats {
+    uint64_t cpu_ns;                 // Tiempo de CPU total (schedstat; ver thread_cpu_ns)
+    uint64_t user_ms;                // utime (stat)
+    uint64_t system_ms;              // stime (stat)
+    uint64_t run_queue_wait_ns;      // Tiempo listo esperando CPU del kernel (schedstat)
+    uint64_t voluntary_switches;     // voluntary_ctxt_switches (status)
+    uint64_t involuntary_switches;   // nonvoluntary_ctxt_switches (status)
+
+    ThreadStats()
+        : cpu_ns(0), user_ms(0), system_ms(0), run_queue_wait_ns(0),
+          voluntary_switches(0), involuntary_switches(0) {}
+};
+
+// TID del hilo que llama (gettid)
+pid_t current_thread_id();
+
+// Tiempo de CPU del hilo que llama con CLOCK_THREAD_CPUTIME_ID, en nanosegundos
+uint64_t current_thread_cpu_ns();
+
+// Tiempo de CPU de otro hilo vivo con su reloj (pthread_getcpuclockid + clock_gettime).
+// El hilo no puede haberse unido con join. Retorna false si el reloj no se puede leer
+bool thread_cpu_ns(pthread_t thread, uint64_t& cpu_ns);
+
+// Lee los contadores de un hilo de este proceso. Retorna false si el hilo ya no existe
+bool read_thread_stats(pid_t tid, ThreadStats& stats);
+
+#endif // THREAD_STATS_H
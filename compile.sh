@@ -3,12 +3,13 @@
 echo "Compilando Simple OS Simulator..."
 
 # Limpiar archivos anteriores
-rm -f *.o os_sim
+rm -f *.o os_sim os_sim_loadgen
 
 # Compilar con manejo de errores
 g++ -std=c++17 -Wall -Wextra -O2 -pthread \
-    main.cpp MemoryManager.cpp ProcessScheduler.cpp Shell.cpp \
-    -o os_sim
+    main.cpp MemoryManager.cpp BitmapAllocator.cpp ProcessArena.cpp ThreadStats.cpp ProcessScheduler.cpp CommandLine.cpp Shell.cpp ControlServer.cpp \
+    -o os_sim && \
+g++ -std=c++17 -Wall -Wextra -O2 -pthread loadgen.cpp -o os_sim_loadgen
 
 if [ $? -eq 0 ]; then
     echo "✅ Compilación exitosa!"
@@ -0,0 +1,251 @@
+// Cliente generador de carga para el servidor de control (ControlServer).
+// Abre varias conexiones concurrentes, envía peticiones en pipeline y
+// mide throughput y latencia de cada lote.
+//
+// Uso: ./os_sim_loadgen [-s ruta] [-c clientes] [-n peticiones] [-p pipeline]
+//                       [-m ping|mem|ps|alloc] [-x "comando"]
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct Options {
+    std::string socket_path = "/tmp/os_sim.sock";
+    int clients = 4;              // Conexiones concurrentes (un hilo cada una)
+    long requests = 10000;        // Peticiones por cliente
+    int pipeline = 32;            // Peticiones enviadas antes de leer respuestas
+    std::string mode = "ping";    // ping | mem | ps | alloc (alloc + free)
+    std::string command;          // Comando personalizado (-x)
+};
+
+struct ClientResult {
+    long completed = 0;
+    long errors = 0;
+    std::vector<double> batch_latency_us;  // Latencia de ida y vuelta por lote
+    std::string failure;
+};
+
+// Lee respuestas del protocolo: "OK <n>" + n líneas, o "ERR <mensaje>"
+class ResponseReader {
+private:
+    int fd;
+    std::string buffer;
+    size_t pos;
+
+    bool read_line(std::string& line) {
+        while (true) {
+            size_t newline = buffer.find('\n', pos);
+            if (newline != std::string::npos) {
+                line = buffer.substr(pos, newline - pos);
+                pos = newline + 1;
+                return true;
+            }
+            buffer.erase(0, pos);
+            pos = 0;
+
+            char chunk[16384];
+            ssize_t r = read(fd, chunk, sizeof(chunk));
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(r));
+        }
+    }
+
+public:
+    explicit ResponseReader(int f) : fd(f), pos(0) {}
+
+    // Retorna false si se cerró la conexión. 'ok' indica OK/ERR y 'first_data' la primera línea de datos
+    bool next(bool& ok, std::string& first_data) {
+        std::string header;
+        if (!read_line(header)) return false;
+
+        ok = header.compare(0, 3, "OK ") == 0;
+        first_data.clear();
+        if (!ok) return true;
+
+        long lines = std::stol(header.substr(3));
+        std::string line;
+        for (long i = 0; i < lines; ++i) {
+            if (!read_line(line)) return false;
+            if (i == 0) first_data = line;
+        }
+        return true;
+    }
+};
+
+static bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t w = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        sent += static_cast<size_t>(w);
+    }
+    return true;
+}
+
+static int connect_to(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Envía un lote, lee todas sus respuestas y devuelve los primeros datos de cada una
+static bool run_batch(int fd, ResponseReader& reader, const std::string& batch, long count,
+                      ClientResult& result, std::vector<std::string>* data) {
+    auto start = std::chrono::steady_clock::now();
+    if (!send_all(fd, batch)) return false;
+
+    bool ok;
+    std::string first;
+    for (long i = 0; i < count; ++i) {
+        if (!reader.next(ok, first)) return false;
+        if (ok) {
+            result.completed++;
+            if (data) data->push_back(first);
+        } else {
+            result.errors++;
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    result.batch_latency_us.push_back(
+        std::chrono::duration<double, std::micro>(elapsed).count());
+    return true;
+}
+
+static void run_client(const Options& opts, ClientResult& result) {
+    int fd = connect_to(opts.socket_path);
+    if (fd < 0) {
+        result.failure = std::string("connect: ") + std::strerror(errno);
+        return;
+    }
+
+    ResponseReader reader(fd);
+    std::string line = opts.command.empty() ? (opts.mode == "alloc" ? "alloc 16" : opts.mode)
+                                            : opts.command;
+    line += "\n";
+
+    long remaining = opts.requests;
+    while (remaining > 0) {
+        long count = std::min<long>(opts.pipeline, remaining);
+        std::string batch;
+        batch.reserve(line.size() * count);
+        for (long i = 0; i < count; ++i) batch += line;
+
+        if (opts.mode == "alloc" && opts.command.empty()) {
+            // Cada alloc exitoso se libera en un segundo lote
+            std::vector<std::string> addrs;
+            if (!run_batch(fd, reader, batch, count, result, &addrs)) break;
+            std::string frees;
+            for (const auto& addr : addrs) frees += "free " + addr + "\n";
+            if (!addrs.empty() &&
+                !run_batch(fd, reader, frees, static_cast<long>(addrs.size()), result, nullptr)) {
+                break;
+            }
+        } else if (!run_batch(fd, reader, batch, count, result, nullptr)) {
+            break;
+        }
+        remaining -= count;
+    }
+
+    if (remaining > 0 && result.failure.empty()) {
+        result.failure = "conexión cerrada por el servidor";
+    }
+    close(fd);
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+static void usage(const char* prog) {
+    std::cerr << "Uso: " << prog << " [-s ruta] [-c clientes] [-n peticiones] [-p pipeline]\n"
+              << "       [-m ping|mem|ps|alloc] [-x \"comando\"]\n";
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                usage(argv[0]);
+                return 1;
+            }
+            if (arg == "-s") opts.socket_path = argv[++i];
+            else if (arg == "-c") opts.clients = std::stoi(argv[++i]);
+            else if (arg == "-n") opts.requests = std::stol(argv[++i]);
+            else if (arg == "-p") opts.pipeline = std::stoi(argv[++i]);
+            else if (arg == "-m") opts.mode = argv[++i];
+            else if (arg == "-x") opts.command = argv[++i];
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (opts.clients < 1 || opts.requests < 1 || opts.pipeline < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "[LOADGEN] " << opts.clients << " clientes x " << opts.requests
+              << " peticiones, pipeline " << opts.pipeline << ", modo "
+              << (opts.command.empty() ? opts.mode : "'" + opts.command + "'") << "\n";
+
+    std::vector<ClientResult> results(opts.clients);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < opts.clients; ++i) {
+        threads.emplace_back(run_client, std::cref(opts), std::ref(results[i]));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long completed = 0, errors = 0;
+    std::vector<double> latencies;
+    for (const auto& r : results) {
+        completed += r.completed;
+        errors += r.errors;
+        latencies.insert(latencies.end(), r.batch_latency_us.begin(), r.batch_latency_us.end());
+        if (!r.failure.empty()) {
+            std::cout << "[LOADGEN] Error en cliente: " << r.failure << "\n";
+        }
+    }
+
+    std::cout << "[LOADGEN] Respuestas OK: " << completed << " | ERR: " << errors << "\n";
+    std::cout << "[LOADGEN] Tiempo: " << seconds << " s | Throughput: "
+              << static_cast<long>((completed + errors) / seconds) << " peticiones/s\n";
+    std::cout << "[LOADGEN] Latencia por lote (us): p50 " << percentile(latencies, 0.50)
+              << " | p99 " << percentile(latencies, 0.99) << "\n";
+
+    return errors == 0 && completed > 0 ? 0 : 1;
+}
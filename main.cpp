@@ -1,25 +1,58 @@
 #include "MemoryManager.h"
 #include "ProcessScheduler.h"
 #include "Shell.h"
+#include "ControlServer.h"
 #include <iostream>
 #include <csignal>
 #include <memory>
+#include <string>
+#include <thread>
+#include <chrono>
 
 // Variables globales para el manejo de señales
 Shell* global_shell = nullptr;
+volatile std::sig_atomic_t stop_requested = 0;  // Para el modo sin shell (--no-shell)
 
 // Manejador de señales (Ctrl+C)
 void signal_handler(int senal) {
     std::cout << "\n[SISTEMA] Señal recibida (" << senal  << "). Cerrando sistema...\n";
+    stop_requested = 1;
     if (global_shell) {
         global_shell->stop();
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         std::cout << "Iniciando Simple OS Simulator...\n";
         
+        // Opciones:
+        //   --bitmap <unidad>  usar el backend de mapa de bits (p. ej. 16 o 64 bytes)
+        //   --socket <ruta>    aceptar comandos por un socket Unix (ControlServer)
+        //   --no-shell         no leer comandos de stdin (requiere --socket)
+        size_t unit_size = 0;
+        std::string socket_path;
+        bool interactive = true;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--bitmap") {
+                unit_size = (i + 1 < argc) ? std::stoull(argv[++i]) : 16;
+            } else if (arg == "--socket" && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else if (arg == "--no-shell") {
+                interactive = false;
+            } else {
+                std::cerr << "[MAIN] Opción desconocida: " << arg << "\n";
+                std::cerr << "Uso: " << argv[0]
+                          << " [--bitmap <unidad_bytes>] [--socket <ruta> [--no-shell]]\n";
+                return 1;
+            }
+        }
+        if (!interactive && socket_path.empty()) {
+            std::cerr << "[MAIN] --no-shell requiere --socket <ruta>\n";
+            return 1;
+        }
+        
         // Configurar manejador de señales
         std::signal(SIGINT, signal_handler);
         std::signal(SIGTERM, signal_handler);
@@ -28,7 +61,7 @@ int main() {
         const size_t TOTAL_MEMORY = 8192; // 8KB (1024 bytes)
         
         std::cout << "[MAIN] Creando gestor de memoria...\n";
-        MemoryManager memory_manager(TOTAL_MEMORY);
+        MemoryManager memory_manager(TOTAL_MEMORY, unit_size);
         
         std::cout << "[MAIN] Creando planificador de procesos...\n";
         ProcessScheduler process_scheduler(memory_manager);
@@ -40,11 +73,36 @@ int main() {
         // Mostrar información del sistema
         std::cout << "\n[MAIN] Sistema operativo inicializado exitosamente\n";
         std::cout << "[MAIN] Memoria total disponible: " << TOTAL_MEMORY << " bytes\n";
-        std::cout << "[MAIN] Algoritmo de asignación de memoria: First-Fit\n";
+        std::cout << "[MAIN] Algoritmo de asignación de memoria: First-Fit"
+                  << (unit_size > 0 ? " (mapa de bits)" : "") << "\n";
         std::cout << "[MAIN] Algoritmo de planificación: FCFS (First-Come, First-Served)\n";
         
+        // Servidor de control opcional: comparte memory_manager y process_scheduler con el shell
+        std::unique_ptr<ControlServer> control_server;
+        if (!socket_path.empty()) {
+            control_server = std::make_unique<ControlServer>(memory_manager, process_scheduler, socket_path);
+            if (!control_server->start()) {
+                return 1;
+            }
+        }
+        
         // Ejecuta 
-        shell.run();
+        process_scheduler.start_scheduler();
+        if (interactive) {
+            shell.run();
+        } else {
+            // Sin shell: el sistema atiende solo al socket hasta recibir SIGINT/SIGTERM
+            while (!stop_requested) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        }
+        
+        // Parar primero el servidor: así ninguna petición del socket toca el
+        // scheduler mientras stop_scheduler() vacía sus listas
+        if (control_server) {
+            control_server->stop();
+        }
+        process_scheduler.stop_scheduler();
         
         std::cout << "[MAIN] Sistema operativo terminado correctamente\n";
         